@@ -0,0 +1,290 @@
+/**
+ * @file ww_log_async.c
+ * @brief Background drain thread and flush policy for async mode
+ * @date 2026-10-16
+ *
+ * The drain thread is the single consumer of the RAM ring. ww_log_flush()
+ * may consume from another thread, so the consumer side is serialized by
+ * g_drain_lock (producers never take it).
+ */
+
+#include "ww_log.h"
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef WW_LOG_ASYNC_EN
+
+/* ========== Global Variables ========== */
+
+/**
+ * Current flush policy
+ */
+WW_LOG_ASYNC_CFG_T g_ww_log_async_cfg = {
+    .flush_bytes = WW_LOG_ASYNC_FLUSH_BYTES,
+    .flush_records = WW_LOG_ASYNC_FLUSH_RECORDS,
+    .flush_interval_ms = WW_LOG_ASYNC_FLUSH_INTERVAL_MS,
+    .flush_on_err = WW_LOG_ASYNC_FLUSH_ON_ERR,
+};
+
+static pthread_mutex_t g_drain_lock = PTHREAD_MUTEX_INITIALIZER;  /* Consumer side */
+static pthread_mutex_t g_wake_lock = PTHREAD_MUTEX_INITIALIZER;   /* Guards g_wake_cond */
+static pthread_cond_t g_wake_cond;     /* CLOCK_MONOTONIC, see ww_log_async_once() */
+static pthread_once_t g_wake_once = PTHREAD_ONCE_INIT;
+#ifdef WW_LOG_ASYNC_BLOCK_EN
+static pthread_cond_t g_room_cond;     /* Ring space freed (guarded by g_wake_lock) */
+static U32 g_room_waiters;
+#endif
+static pthread_t g_drain_thread;
+static U8 g_running;
+static U8 g_kicked;
+
+/* Batch buffers, only touched with g_drain_lock held */
+static U32 g_batch_words[WW_LOG_ASYNC_BATCH_WORDS];
+static char g_batch_text[WW_LOG_ASYNC_BATCH_WORDS * 12 + WW_LOG_ASYNC_LINE_MAX];
+static struct iovec g_batch_iov[WW_LOG_ASYNC_BATCH_WORDS];  /* One per record */
+
+/* ========== Internal Functions ========== */
+
+/**
+ * @brief Initialise g_wake_cond (once)
+ *
+ * The timed wait uses CLOCK_MONOTONIC, which PTHREAD_COND_INITIALIZER
+ * cannot select. Run through pthread_once() by every user of the
+ * condition, since the flush policy can be set (and producers can kick)
+ * before ww_log_init().
+ */
+static void ww_log_async_once(void)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_wake_cond, &attr);
+#ifdef WW_LOG_ASYNC_BLOCK_EN
+    pthread_cond_init(&g_room_cond, &attr);
+#endif
+    pthread_condattr_destroy(&attr);
+}
+
+/**
+ * @brief Move everything out of the ring and write it as one batch per read
+ *
+ * Each record is rendered into g_batch_text and gets its own iovec, so a
+ * whole batch reaches each sink as a single writev.
+ * Caller must hold g_drain_lock.
+ */
+static void ww_log_async_drain_locked(void)
+{
+    U32 words;
+
+    while ((words = ww_log_ram_read(g_batch_words, WW_LOG_ASYNC_BATCH_WORDS)) != 0) {
+        U32 idx = 0;
+        U32 len = 0;
+        U32 count = 0;
+
+#ifdef WW_LOG_ASYNC_BLOCK_EN
+        /* Producers waiting for space can go on while this batch is written */
+        if (__atomic_load_n(&g_room_waiters, __ATOMIC_RELAXED) != 0) {
+            pthread_mutex_lock(&g_wake_lock);
+            pthread_cond_broadcast(&g_room_cond);
+            pthread_mutex_unlock(&g_wake_lock);
+        }
+#endif
+
+        while (idx < words) {
+            U32 rec_len;
+
+            /* Deferred string records can render to more than 12 bytes per word */
+            if (sizeof(g_batch_text) - len < WW_LOG_ASYNC_LINE_MAX + 1) {
+                ww_log_sink_writev(g_batch_iov, count);
+                len = 0;
+                count = 0;
+            }
+
+            rec_len = ww_log_async_render(&g_batch_words[idx], &g_batch_text[len],
+                                          sizeof(g_batch_text) - len);
+
+            g_batch_iov[count].iov_base = &g_batch_text[len];
+            g_batch_iov[count].iov_len = rec_len;
+            count++;
+
+            len += rec_len;
+            idx += WW_LOG_RAM_REC_WORDS(g_batch_words[idx]);
+        }
+
+        ww_log_sink_writev(g_batch_iov, count);
+    }
+
+    ww_log_sink_flush();
+}
+
+/**
+ * @brief Drain thread: sleep until a trigger fires or the interval expires
+ */
+static void *ww_log_async_thread(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&g_wake_lock);
+    while (g_running) {
+        if (!g_kicked) {
+            U32 interval_ms = g_ww_log_async_cfg.flush_interval_ms;
+
+            if (interval_ms != 0) {
+                struct timespec deadline;
+
+                clock_gettime(CLOCK_MONOTONIC, &deadline);
+                deadline.tv_sec += interval_ms / 1000;
+                deadline.tv_nsec += (long)(interval_ms % 1000) * 1000000L;
+                if (deadline.tv_nsec >= 1000000000L) {
+                    deadline.tv_sec++;
+                    deadline.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&g_wake_cond, &g_wake_lock, &deadline);
+            } else {
+                pthread_cond_wait(&g_wake_cond, &g_wake_lock);
+            }
+        }
+        __atomic_store_n(&g_kicked, 0, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&g_wake_lock);
+
+        pthread_mutex_lock(&g_drain_lock);
+        ww_log_async_drain_locked();
+        pthread_mutex_unlock(&g_drain_lock);
+
+        pthread_mutex_lock(&g_wake_lock);
+    }
+    pthread_mutex_unlock(&g_wake_lock);
+
+    return NULL;
+}
+
+/* ========== API Implementation ========== */
+
+/**
+ * @brief Start the drain thread
+ */
+S8 ww_log_async_start(void)
+{
+    if (g_running) {
+        return 0;
+    }
+
+    pthread_once(&g_wake_once, ww_log_async_once);
+
+    __atomic_store_n(&g_running, 1, __ATOMIC_RELAXED);
+    if (pthread_create(&g_drain_thread, NULL, ww_log_async_thread, NULL) != 0) {
+        __atomic_store_n(&g_running, 0, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Replace the flush policy
+ */
+void ww_log_async_set_config(const WW_LOG_ASYNC_CFG_T *cfg)
+{
+    pthread_once(&g_wake_once, ww_log_async_once);
+
+    pthread_mutex_lock(&g_wake_lock);
+    g_ww_log_async_cfg = *cfg;
+    pthread_mutex_unlock(&g_wake_lock);
+
+    /* Re-arm the wait with the new interval */
+    ww_log_async_kick();
+}
+
+/**
+ * @brief Read the current flush policy
+ */
+void ww_log_async_get_config(WW_LOG_ASYNC_CFG_T *cfg)
+{
+    *cfg = g_ww_log_async_cfg;
+}
+
+/**
+ * @brief Wake the drain thread
+ *
+ * Only the first producer after a drain pays for the mutex and signal;
+ * the others see g_kicked already set.
+ */
+void ww_log_async_kick(void)
+{
+    if (__atomic_exchange_n(&g_kicked, 1, __ATOMIC_RELAXED) != 0) {
+        return;
+    }
+
+    pthread_once(&g_wake_once, ww_log_async_once);
+
+    pthread_mutex_lock(&g_wake_lock);
+    pthread_cond_signal(&g_wake_cond);
+    pthread_mutex_unlock(&g_wake_lock);
+}
+
+#ifdef WW_LOG_ASYNC_BLOCK_EN
+/**
+ * @brief Wait for the drain thread to free ring space
+ */
+S8 ww_log_async_wait(void)
+{
+    struct timespec deadline;
+
+    if (!__atomic_load_n(&g_running, __ATOMIC_RELAXED) ||
+        pthread_equal(pthread_self(), g_drain_thread)) {
+        return -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_nsec += 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&g_wake_lock);
+    g_room_waiters++;
+    __atomic_store_n(&g_kicked, 1, __ATOMIC_RELAXED);
+    pthread_cond_signal(&g_wake_cond);
+    pthread_cond_timedwait(&g_room_cond, &g_wake_lock, &deadline);
+    g_room_waiters--;
+    pthread_mutex_unlock(&g_wake_lock);
+
+    return 0;
+}
+#endif /* WW_LOG_ASYNC_BLOCK_EN */
+
+/**
+ * @brief Drain the ring on the calling thread
+ */
+void ww_log_flush(void)
+{
+    pthread_mutex_lock(&g_drain_lock);
+    ww_log_async_drain_locked();
+#ifdef WW_LOG_ENCODE_SYNC_EN
+    ww_log_encode_sync();  /* Everything flushed can be checked */
+#endif
+    pthread_mutex_unlock(&g_drain_lock);
+}
+
+/**
+ * @brief Stop the drain thread, write out what is left and close the sinks
+ */
+void ww_log_shutdown(void)
+{
+    if (g_running) {
+        pthread_mutex_lock(&g_wake_lock);
+        __atomic_store_n(&g_running, 0, __ATOMIC_RELAXED);
+        pthread_cond_signal(&g_wake_cond);
+        pthread_mutex_unlock(&g_wake_lock);
+
+        pthread_join(g_drain_thread, NULL);
+    }
+
+    ww_log_flush();
+    ww_log_sink_close_all();
+}
+
+#endif /* WW_LOG_ASYNC_EN */
@@ -6,25 +6,99 @@
 
 #include "ww_log.h"
 #include <stdio.h>
+#include <stdlib.h>
 
 /**
- * @brief Initialize log system (optional, for future extensions)
+ * Default sink, used when no sink was registered before ww_log_init()
+ */
+static WW_LOG_SINK_T g_ww_log_stdout_sink;
+
+/**
+ * @brief Initialize log system
+ *
+ * - Persistent ring: map the ring file, recover the previous run
+ * - Register the stdout sink if no sink was registered
+ * - Encode mode: write the stream header
+ * - Timestamps: write the clock calibration and first sync record
+ * - Async mode: start the drain thread
+ * - Register ww_log_shutdown() atexit (all modes)
  *
- * Currently this is a placeholder. Future enhancements might include:
+ * Future enhancements might include:
  * - UART initialization
- * - RAM buffer warm restart detection
- * - Output hook configuration
  */
 void ww_log_init(void)
 {
-    printf("LOG: System initialized (mode: ");
+    /* Status messages go to stderr: stdout is the default sink's stream */
+    fprintf(stderr, "LOG: System initialized (mode: ");
 #if defined(WW_LOG_MODE_ENCODE)
-    printf("ENCODE)\n");
+    fprintf(stderr, "ENCODE)\n");
 #elif defined(WW_LOG_MODE_STR)
-    printf("STRING)\n");
+    fprintf(stderr, "STRING)\n");
 #elif defined(WW_LOG_MODE_DISABLED)
-    printf("DISABLED)\n");
+    fprintf(stderr, "DISABLED)\n");
 #else
-    printf("UNKNOWN)\n");
+    fprintf(stderr, "UNKNOWN)\n");
+#endif
+
+#ifdef WW_LOG_RAM_PERSIST_EN
+    if (ww_log_ram_persist_open() > 0) {
+        U32 words;
+
+        ww_log_ram_prev_get(&words);
+        fprintf(stderr, "LOG: Recovered %u words from the previous run\n", words);
+    }
+#endif
+
+    if (ww_log_sink_count() == 0) {
+        ww_log_sink_file_init(&g_ww_log_stdout_sink, stdout);
+        ww_log_sink_add(&g_ww_log_stdout_sink);
+    }
+
+#ifdef WW_LOG_MODE_ENCODE
+    ww_log_encode_stream_start();
+#endif
+
+#ifdef WW_LOG_ENCODE_TIMESTAMP_EN
+    ww_log_time_start();
+#endif
+
+#ifdef WW_LOG_ASYNC_EN
+    if (ww_log_async_start() != 0) {
+        fprintf(stderr, "LOG: Failed to start drain thread, records stay in RAM ring\n");
+    }
+#endif
+
+    /* Every mode: drain, close the last sync block and the sinks at exit */
+    {
+        static U8 s_atexit_done = 0;
+
+        if (!s_atexit_done) {
+            atexit(ww_log_shutdown);
+            s_atexit_done = 1;
+        }
+    }
+}
+
+#ifndef WW_LOG_ASYNC_EN
+/**
+ * @brief Flush output (sync modes write through, so only sinks are flushed)
+ */
+void ww_log_flush(void)
+{
+#ifdef WW_LOG_ENCODE_SYNC_EN
+    ww_log_encode_sync();
+#endif
+    ww_log_sink_flush();
+}
+
+/**
+ * @brief Nothing to stop in sync modes, close the last block and the sinks
+ */
+void ww_log_shutdown(void)
+{
+#ifdef WW_LOG_ENCODE_SYNC_EN
+    ww_log_encode_sync();
 #endif
+    ww_log_sink_close_all();
 }
+#endif /* !WW_LOG_ASYNC_EN */
@@ -1,116 +1,92 @@
 /**
  * @file ww_log_encode.c
- * @brief Encode mode logging implementation (variadic function version)
+ * @brief Encode mode logging implementation (fixed-arity and variadic functions)
  * @date 2025-12-17
  */
 
 #include "ww_log.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 
 #ifdef WW_LOG_MODE_ENCODE
 
-/* ========== RAM Buffer (Optional) ========== */
-
-#ifdef WW_LOG_ENCODE_RAM_BUFFER_EN
+#ifdef WW_LOG_ENCODE_SYNC_EN
+#include <pthread.h>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+#endif
 
 /**
- * Global RAM buffer instance
+ * String table section bounds (defined by the linker; weak, so a program
+ * without interned strings still links)
  */
-WW_LOG_RAM_BUFFER_T g_ww_log_ram_buffer = {
-    .magic = WW_LOG_RAM_MAGIC,
-    .head = 0,
-    .tail = 0,
-    .entries = {0}
-};
-
-/**
- * @brief Check if RAM buffer is full
- * @return 1 if full, 0 if not full
- */
-static U8 ww_log_ram_is_full(void)
-{
-    U16 next_tail = (g_ww_log_ram_buffer.tail + 1) % WW_LOG_RAM_BUFFER_SIZE;
-    return (next_tail == g_ww_log_ram_buffer.head);
-}
-
-/**
- * @brief Write one U32 entry to RAM buffer
- * @param data Data to write
- * @return 0 on success, -1 if buffer full
- */
-static S8 ww_log_ram_write(U32 data)
-{
-    if (ww_log_ram_is_full()) {
-        /* Buffer full - drop new entry */
-        return -1;
-    }
-
-    /* Write data */
-    g_ww_log_ram_buffer.entries[g_ww_log_ram_buffer.tail] = data;
+extern const char __start_ww_log_strtab[] __attribute__((weak));
+extern const char __stop_ww_log_strtab[] __attribute__((weak));
 
-    /* Advance tail pointer */
-    g_ww_log_ram_buffer.tail = (g_ww_log_ram_buffer.tail + 1) % WW_LOG_RAM_BUFFER_SIZE;
+/* ========== RAM Buffer (Optional) ========== */
 
-    return 0;
-}
-
-/**
- * @brief Get number of entries in RAM buffer
- * @return Number of entries
- */
-U16 ww_log_ram_get_count(void)
-{
-    if (g_ww_log_ram_buffer.tail >= g_ww_log_ram_buffer.head) {
-        return g_ww_log_ram_buffer.tail - g_ww_log_ram_buffer.head;
-    } else {
-        return WW_LOG_RAM_BUFFER_SIZE - g_ww_log_ram_buffer.head + g_ww_log_ram_buffer.tail;
-    }
-}
+#ifdef WW_LOG_RAM_BUFFER_EN
 
 /**
  * @brief Dump all entries in RAM buffer to stdout
+ *
+ * The dump only peeks at the published records; it does not consume them.
+ * Call ww_log_ram_clear() afterwards to release the space.
  */
 void ww_log_ram_dump(void)
 {
+    U32 head = __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_ACQUIRE);
+    U32 tail = __atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_ACQUIRE);
+    U32 idx = head;
+    U16 count = 0;
+
     printf("\n===== LOG RAM BUFFER DUMP =====\n");
     printf("Magic: 0x%08X %s\n",
            g_ww_log_ram_buffer.magic,
            (g_ww_log_ram_buffer.magic == WW_LOG_RAM_MAGIC) ? "(VALID)" : "(INVALID)");
-    printf("Head: %u, Tail: %u, Count: %u\n",
-           g_ww_log_ram_buffer.head,
-           g_ww_log_ram_buffer.tail,
-           ww_log_ram_get_count());
+    printf("Head: %u, Tail: %u, Count: %u\n", head, tail, tail - head);
     printf("-------------------------------\n");
 
-    U16 idx = g_ww_log_ram_buffer.head;
-    U16 count = 0;
+    while (idx != tail) {
+        WW_LOG_HDR_T entry = __atomic_load_n(&WW_LOG_RAM_SLOT(idx), __ATOMIC_ACQUIRE);
 
-    while (idx != g_ww_log_ram_buffer.tail) {
-        U32 entry = g_ww_log_ram_buffer.entries[idx];
+        if (entry == 0) {
+            break;  /* Record still being written */
+        }
+
+#ifndef WW_LOG_ENCODE_V1
+        /* LINE word, published together with word 0 */
+        entry |= (WW_LOG_HDR_T)WW_LOG_RAM_SLOT(idx + 1) << 32;
+#endif
 
         /* Decode and print */
         U16 log_id = WW_LOG_DECODE_LOG_ID(entry);
-        U16 line = WW_LOG_DECODE_LINE(entry);
+        U32 line = WW_LOG_DECODE_LINE(entry);
         U8 data_len = WW_LOG_DECODE_DATA_LEN(entry);
         U8 level = WW_LOG_DECODE_LEVEL(entry);
 
-        printf("[%04u] 0x%08X -> LogID:%3u Line:%4u DataLen:%u Level:%u",
+        printf("[%04u] 0x%08X -> LogID:%3u Line:%4u DataLen:%u Level:%u%s",
                count++,
-               entry,
-               log_id,
+               WW_LOG_HDR_WORD(entry, 0),
+               (log_id == WW_LOG_CTRL_LOG_ID) ? log_id : WW_LOG_DECODE_FILE_ID(entry),
                line,
                data_len,
-               level);
+               level,
+               (log_id == WW_LOG_CTRL_LOG_ID) ? " Control" :
+               WW_LOG_DECODE_EXT(entry) ? " Typed" : "");
 
-        idx = (idx + 1) % WW_LOG_RAM_BUFFER_SIZE;
+        idx += WW_LOG_HDR_WORDS;
 
         /* Print parameters if any */
         if (data_len > 0) {
             printf(" Params:");
-            for (U8 i = 0; i < data_len && idx != g_ww_log_ram_buffer.tail; i++) {
-                printf(" 0x%08X", g_ww_log_ram_buffer.entries[idx]);
-                idx = (idx + 1) % WW_LOG_RAM_BUFFER_SIZE;
+            for (U8 i = 0; i < data_len && idx != tail; i++) {
+                printf(" 0x%08X", WW_LOG_RAM_SLOT(idx));
+                idx++;
             }
         }
         printf("\n");
@@ -119,82 +95,1076 @@ void ww_log_ram_dump(void)
     printf("===============================\n\n");
 }
 
+#endif /* WW_LOG_RAM_BUFFER_EN */
+
+/* ========== Output Rendering ========== */
+
+/**
+ * @brief Render a run of stream words in the configured output format
+ * @param rec Words (one record or frame)
+ * @param words Number of words
+ * @param out Output buffer
+ * @param size Output buffer size
+ * @return Number of bytes written to out
+ *
+ * - Hex text (default): 0xHHHHHHHH 0xPPPPPPPP ...\n
+ * - Binary (WW_LOG_ENCODE_OUTPUT_BIN): the raw words in native byte order
+ */
+static U32 ww_log_encode_render_words(const U32 *rec, U32 words, char *out, U32 size)
+{
+    U32 len = 0;
+
+#ifdef WW_LOG_ENCODE_OUTPUT_BIN
+    len = words * 4;
+    if (len > size) {
+        len = size & ~3U;
+    }
+    memcpy(out, rec, len);
+#else
+    U32 i;
+
+    for (i = 0; i < words && len + 12 <= size; i++) {
+        len += (U32)snprintf(&out[len], size - len, (i == 0) ? "0x%08X" : " 0x%08X", rec[i]);
+    }
+    if (len < size) {
+        out[len++] = '\n';
+    }
+#endif
+
+    return len;
+}
+
+#ifdef WW_LOG_ENCODE_SYNC_EN
+/* ========== Stream Sync Frames ========== */
+
+/* Output space of one frame (hex text; binary needs 12 bytes) */
+#define WW_LOG_SYNC_FRAME_TEXT  (3 * 11 + 1)
+
+/**
+ * Open block: running CRC, records since the last frame, next SEQ.
+ * Updated in output order: under g_sync_lock (direct output) or the
+ * drain lock (async mode).
+ */
+static U32 g_sync_crc = 0xFFFFFFFF;
+static U32 g_sync_records;
+static U32 g_sync_seq;
+
+#ifndef WW_LOG_ASYNC_EN
+/*
+ * Held around render + sink write. The write can block on a slow sink
+ * (UART, pipe), so waiters must sleep rather than spin.
+ */
+static pthread_mutex_t g_sync_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline void ww_log_sync_lock(void)
+{
+    pthread_mutex_lock(&g_sync_lock);
+}
+
+static inline void ww_log_sync_unlock(void)
+{
+    pthread_mutex_unlock(&g_sync_lock);
+}
+#endif
+
+#if !defined(__SSE4_2__) && !defined(__ARM_FEATURE_CRC32)
+/**
+ * CRC32C tables (reflected 0x82F63B78) for slicing by 4: table[k][b] is
+ * the CRC of byte b followed by k zero bytes, so one word takes four
+ * independent lookups. Built by ww_log_encode_stream_start().
+ */
+static U32 g_sync_crc_table[4][256];
+
+static void ww_log_sync_crc_init(void)
+{
+    U32 i;
+    U32 k;
+
+    for (i = 0; i < 256; i++) {
+        U32 crc = i;
+
+        for (k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0x82F63B78U & (0U - (crc & 1U)));
+        }
+        g_sync_crc_table[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++) {
+        for (k = 1; k < 4; k++) {
+            U32 prev = g_sync_crc_table[k - 1][i];
+
+            g_sync_crc_table[k][i] = (prev >> 8) ^ g_sync_crc_table[0][prev & 0xFF];
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Add words to a CRC32C, low byte of each word first
+ */
+static inline U32 ww_log_sync_crc(U32 crc, const U32 *words, U32 count)
+{
+    U32 i;
+
+    for (i = 0; i < count; i++) {
+#if defined(__SSE4_2__)
+        crc = _mm_crc32_u32(crc, words[i]);
+#elif defined(__ARM_FEATURE_CRC32)
+        crc = __crc32cw(crc, words[i]);
+#else
+        crc ^= words[i];
+        crc = g_sync_crc_table[3][crc & 0xFF] ^ g_sync_crc_table[2][(crc >> 8) & 0xFF] ^
+              g_sync_crc_table[1][(crc >> 16) & 0xFF] ^ g_sync_crc_table[0][crc >> 24];
+#endif
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Render the frame closing the open block and start a new block
+ * @return Number of bytes written to out
+ */
+static U32 ww_log_sync_frame(char *out, U32 size)
+{
+    U32 frame[3];
+
+    frame[0] = WW_LOG_SYNC_MAGIC;
+    frame[1] = g_sync_seq++;
+    frame[2] = ~g_sync_crc;
+
+    g_sync_crc = 0xFFFFFFFF;
+    g_sync_records = 0;
+
+    return ww_log_encode_render_words(frame, 3, out, size);
+}
+
+/**
+ * @brief Close the current block with a sync frame
+ */
+void ww_log_encode_sync(void)
+{
+    char out[WW_LOG_SYNC_FRAME_TEXT];
+    U32 len = 0;
+
+#ifndef WW_LOG_ASYNC_EN
+    ww_log_sync_lock();
+#endif
+    if (g_sync_records != 0) {
+        len = ww_log_sync_frame(out, sizeof(out));
+        ww_log_sink_write(out, len);
+    }
+#ifndef WW_LOG_ASYNC_EN
+    ww_log_sync_unlock();
+#endif
+
+    if (len != 0) {
+        ww_log_sink_flush();
+    }
+}
+#else
+#define WW_LOG_SYNC_FRAME_TEXT  0
+#endif /* WW_LOG_ENCODE_SYNC_EN */
+
+/**
+ * @brief Render one record for the output stream
+ * @param rec Record words (header first)
+ * @param out Output buffer
+ * @param size Output buffer size
+ * @return Number of bytes written to out
+ *
+ * With sync frames the record is added to the block CRC, and the frame
+ * closing the block follows the record every WW_LOG_SYNC_INTERVAL records
+ * (or after the next one, if out has no room left for it).
+ */
+static U32 ww_log_encode_render(const U32 *rec, char *out, U32 size)
+{
+    U32 words = WW_LOG_REC_WORDS(rec[0]);
+    U32 len = ww_log_encode_render_words(rec, words, out, size);
+
+#ifdef WW_LOG_ENCODE_SYNC_EN
+    g_sync_crc = ww_log_sync_crc(g_sync_crc, rec, words);
+    g_sync_records++;
+    if (g_sync_records >= WW_LOG_SYNC_INTERVAL && len + WW_LOG_SYNC_FRAME_TEXT <= size) {
+        len += ww_log_sync_frame(&out[len], size - len);
+    }
+#endif
+
+    return len;
+}
+
 /**
- * @brief Clear RAM buffer
+ * @brief Write the stream header (see WW_LOG_STREAM_MAGIC)
+ *
+ * Called once by ww_log_init() before the first record is written.
+ * Nothing is written when records only go to the RAM ring.
  */
-void ww_log_ram_clear(void)
+void ww_log_encode_stream_start(void)
 {
-    g_ww_log_ram_buffer.head = 0;
-    g_ww_log_ram_buffer.tail = 0;
+#if !defined(WW_LOG_RAM_BUFFER_EN) || defined(WW_LOG_ASYNC_EN)
+    U32 hdr[3] = {
+        WW_LOG_STREAM_MAGIC,
+        WW_LOG_STREAM_VERSION | (WW_LOG_STREAM_FLAGS << 16),
+        WW_LOG_STREAM_BOM,
+    };
+
+#ifdef WW_LOG_ENCODE_OUTPUT_BIN
+    ww_log_sink_write(hdr, sizeof(hdr));
+#else
+    char text[3 * 11 + 1];
+    int len = snprintf(text, sizeof(text), "0x%08X 0x%08X 0x%08X\n", hdr[0], hdr[1], hdr[2]);
+
+    ww_log_sink_write(text, (U32)len);
+#endif
+    ww_log_sink_flush();
+
+#if defined(WW_LOG_ENCODE_SYNC_EN) && !defined(__SSE4_2__) && !defined(__ARM_FEATURE_CRC32)
+    ww_log_sync_crc_init();
+#endif
+#endif /* Records reach the output */
 }
 
-#endif /* WW_LOG_ENCODE_RAM_BUFFER_EN */
+#ifdef WW_LOG_ASYNC_EN
+/**
+ * @brief Render one encoded record for the drain thread
+ */
+U32 ww_log_async_render(const U32 *rec, char *out, U32 size)
+{
+    return ww_log_encode_render(rec, out, size);
+}
+#endif /* WW_LOG_ASYNC_EN */
 
 /* ========== Core Encoding Function ========== */
 
+/**
+ * @brief Check the dynamic switches for a record
+ * @return Non-zero if the record should be written
+ *
+ * Module mask and the module / file level thresholds, combined in
+ * the level table (the LOG_ID of a record is its file ID)
+ */
+static inline U8 ww_log_encode_enabled(U16 log_id, U8 level)
+{
+    return ww_log_level_enabled(log_id, level);
+}
+
+/**
+ * @brief Write one filtered record
+ * @param encoded_log Record header
+ * @param params Payload words
+ * @param param_count Number of payload words (DATA_LEN of the header)
+ * @return 0 if the record was written, -1 if it was dropped (ring full)
+ *
+ * Inlined into each entry point, where the fixed-arity ones pass a
+ * constant param_count so the copy loops unroll.
+ *
+ * With the RAM buffer enabled, the record is reserved in the lock-free
+ * ring with a single atomic step, the parameters are copied into their
+ * slots and the header store publishes the record - no stdio, no lock.
+ * Otherwise the record is rendered as hex text or raw binary words and
+ * handed to the sinks in a single write.
+ */
+static inline __attribute__((always_inline))
+S8 ww_log_encode_emit(WW_LOG_HDR_T encoded_log, const U32 *params, U32 param_count)
+{
+    U32 i;
+
+#ifdef WW_LOG_RAM_BUFFER_EN
+    U32 pos;
+
+    if (ww_log_ram_reserve(WW_LOG_HDR_WORDS + param_count, &pos) != 0) {
+        return -1;  /* Buffer full - drop new record */
+    }
+
+    for (i = 1; i < WW_LOG_HDR_WORDS; i++) {
+        WW_LOG_RAM_SLOT(pos + i) = WW_LOG_HDR_WORD(encoded_log, i);
+    }
+    for (i = 0; i < param_count; i++) {
+        WW_LOG_RAM_SLOT(pos + WW_LOG_HDR_WORDS + i) = params[i];
+    }
+
+    ww_log_ram_commit(pos, WW_LOG_HDR_WORD(encoded_log, 0));
+#ifdef WW_LOG_ASYNC_EN
+    ww_log_async_notify(pos + WW_LOG_HDR_WORDS + param_count, WW_LOG_DECODE_LEVEL(encoded_log));
+#endif
+    return 0;
+#else
+    U32 rec[64];  /* Header + payload: 1 + DATA_LEN words */
+    char out[64 * 11 + 1 + WW_LOG_SYNC_FRAME_TEXT];
+    U32 len;
+
+    for (i = 0; i < WW_LOG_HDR_WORDS; i++) {
+        rec[i] = WW_LOG_HDR_WORD(encoded_log, i);
+    }
+    for (i = 0; i < param_count; i++) {
+        rec[WW_LOG_HDR_WORDS + i] = params[i];
+    }
+
+    /* Output to the sinks: one write per record (and sync frame) */
+#ifdef WW_LOG_ENCODE_SYNC_EN
+    ww_log_sync_lock();  /* Block CRC follows the output order */
+#endif
+    len = ww_log_encode_render(rec, out, sizeof(out));
+    ww_log_sink_write(out, len);
+#ifdef WW_LOG_ENCODE_SYNC_EN
+    ww_log_sync_unlock();
+#endif
+
+#ifndef WW_LOG_ENCODE_OUTPUT_BIN
+    /* Text output is line oriented: flush for immediate visibility */
+    ww_log_sink_flush();
+#endif
+    return 0;
+#endif /* WW_LOG_RAM_BUFFER_EN */
+}
+
+/* ========== Payload Packing ========== */
+
+/**
+ * Payload buffer size: the largest payload a record can carry (DATA_LEN).
+ * Timestamp item, two descriptors and 16 typed parameters of up to 10
+ * bytes (compact) or 1 + 2 + 16 x 2 words (plain) always fit; string
+ * parameters are cut to what is left.
+ */
+#define WW_LOG_PAYLOAD_WORDS  WW_LOG_PAYLOAD_MAX
+
+#ifdef WW_LOG_ENCODE_COMPACT
+#define WW_LOG_ITEM_MAX_BYTES  10  /* Largest non-string item (U64 varint) */
+#else
+#define WW_LOG_ITEM_MAX_BYTES  8   /* Largest non-string item (2 words) */
+#endif
+
+#ifdef WW_LOG_ENCODE_COMPACT
+/**
+ * @brief Append one byte to a compact payload (pos counts bytes)
+ */
+static inline void ww_log_pack_byte(U32 *buf, U32 *pos, U8 byte)
+{
+    U32 shift = (*pos & 3U) * 8;
+
+    if (shift == 0) {
+        buf[*pos >> 2] = 0;
+    }
+    buf[*pos >> 2] |= (U32)byte << shift;
+    (*pos)++;
+}
+
+/**
+ * @brief Append an unsigned LEB128 value
+ */
+static inline void ww_log_pack_varint(U32 *buf, U32 *pos, U64 value)
+{
+    do {
+        U8 byte = (U8)(value & 0x7F);
+
+        value >>= 7;
+        if (value != 0) {
+            byte |= 0x80;
+        }
+        ww_log_pack_byte(buf, pos, byte);
+    } while (value != 0);
+}
+#endif /* WW_LOG_ENCODE_COMPACT */
+
+/**
+ * @brief Copy bytes into consecutive payload words (see WW_LOG_TAG_BLOB)
+ * @param dst First word
+ * @param src Bytes
+ * @param len Number of bytes; the rest of the last word is zeroed
+ *
+ * Byte k goes to bits 8*(k%4)+7..8*(k%4) of word k/4, which is memory
+ * order on little-endian targets: one memcpy there.
+ */
+static inline void ww_log_blob_copy(U32 *dst, const U8 *src, U32 len)
+{
+    if (len == 0) {
+        return;
+    }
+
+    dst[(len - 1) / 4] = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(dst, src, len);
+#else
+    {
+        U32 i;
+
+        for (i = 0; i < len; i++) {
+            if ((i & 3U) == 0) {
+                dst[i >> 2] = 0;
+            }
+            dst[i >> 2] |= (U32)src[i] << ((i & 3U) * 8);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Append one parameter to a payload
+ * @param buf Payload buffer
+ * @param pos Write position (bytes when compact, words otherwise)
+ * @param tag WW_LOG_TAG_xxx of the value
+ * @param value Value bits
+ */
+static inline void ww_log_payload_put(U32 *buf, U32 *pos, U32 tag, U64 value)
+{
+#ifdef WW_LOG_ENCODE_COMPACT
+    U32 i;
+
+    switch (tag) {
+    case WW_LOG_TAG_U64:
+        ww_log_pack_varint(buf, pos, WW_LOG_ZIGZAG64(value));
+        break;
+    case WW_LOG_TAG_PTR32:
+    case WW_LOG_TAG_PTR64:
+        ww_log_pack_varint(buf, pos, value);
+        break;
+    case WW_LOG_TAG_F32:
+    case WW_LOG_TAG_F64:
+        for (i = 0; i < ((tag == WW_LOG_TAG_F32) ? 4U : 8U); i++) {
+            ww_log_pack_byte(buf, pos, (U8)(value >> (i * 8)));
+        }
+        break;
+    default:
+        ww_log_pack_varint(buf, pos, WW_LOG_ZIGZAG32(value));
+        break;
+    }
+#else
+    buf[(*pos)++] = (U32)value;
+    if (tag == WW_LOG_TAG_U64 || tag == WW_LOG_TAG_F64 || tag == WW_LOG_TAG_PTR64) {
+        buf[(*pos)++] = (U32)(value >> 32);
+    }
+#endif
+}
+
+/**
+ * @brief Append a string parameter (see WW_LOG_TAG_STR)
+ * @param buf Payload buffer (WW_LOG_PAYLOAD_WORDS)
+ * @param pos Write position (bytes when compact, words otherwise)
+ * @param str String
+ * @param reserve Bytes to keep free for the parameters after this one
+ *
+ * Interned literals only write their string table ID; other strings are
+ * copied up to WW_LOG_STR_ARG_MAX bytes or the space left in the record.
+ */
+static void ww_log_payload_put_str(U32 *buf, U32 *pos, const char *str, U32 reserve)
+{
+    uintptr_t addr = (uintptr_t)str;
+    U32 room;
+    U32 len;
+    U32 item;
+
+    if (addr >= (uintptr_t)__start_ww_log_strtab && addr < (uintptr_t)__stop_ww_log_strtab) {
+        ww_log_payload_put(buf, pos, WW_LOG_TAG_PTR32,
+                           ((U32)(addr - (uintptr_t)__start_ww_log_strtab) << 1) | WW_LOG_STR_ID_FLAG);
+        return;
+    }
+
+    if (str == NULL) {
+        str = "(null)";
+    }
+
+    /* Space for the bytes: what is left after the length item and the reserve */
+#ifdef WW_LOG_ENCODE_COMPACT
+    room = WW_LOG_PAYLOAD_WORDS * 4 - *pos;
+#else
+    room = (WW_LOG_PAYLOAD_WORDS - *pos) * 4;
+#endif
+    room = (room > reserve + 5) ? room - reserve - 5 : 0;
+    if (room > WW_LOG_STR_ARG_MAX) {
+        room = WW_LOG_STR_ARG_MAX;
+    }
+
+    len = (U32)strnlen(str, room + 1);
+    item = 0;
+    if (len > room) {
+        len = room;
+        item = WW_LOG_STR_TRUNC_FLAG;
+    }
+    ww_log_payload_put(buf, pos, WW_LOG_TAG_PTR32, (len << 2) | item);
+
+#ifdef WW_LOG_ENCODE_COMPACT
+    {
+        U32 i;
+
+        for (i = 0; i < len; i++) {
+            ww_log_pack_byte(buf, pos, (U8)str[i]);
+        }
+    }
+#else
+    ww_log_blob_copy(&buf[*pos], (const U8 *)str, len);
+    *pos += (len + 3) / 4;
+#endif
+}
+
+/**
+ * @brief Close a payload
+ * @return Payload length in words (compact: last word padded)
+ */
+static inline U32 ww_log_payload_finish(U32 *buf, U32 pos)
+{
+#ifdef WW_LOG_ENCODE_COMPACT
+    while ((pos & 3U) != 0) {
+        ww_log_pack_byte(buf, &pos, WW_LOG_COMPACT_PAD);
+    }
+    return pos >> 2;
+#else
+    (void)buf;
+    return pos;
+#endif
+}
+
+/**
+ * @brief Start a payload with the record timestamp (if enabled)
+ */
+static inline void ww_log_payload_begin(U32 *buf, U32 *pos)
+{
+#ifdef WW_LOG_ENCODE_TIMESTAMP_EN
+    ww_log_payload_put(buf, pos, WW_LOG_TAG_PTR32, ww_log_time_item());  /* Unsigned word */
+#else
+    (void)buf;
+    (void)pos;
+#endif
+}
+
+#if defined(WW_LOG_ENCODE_COMPACT) || defined(WW_LOG_ENCODE_TIMESTAMP_EN)
+/* Payload of 16 plain parameters and the timestamp item (compact: 5 bytes each) */
+#define WW_LOG_PLAIN_PAYLOAD_WORDS  ((17 * 5 + 3) / 4)
+
+/**
+ * @brief Build the payload of a record of plain 32-bit parameters
+ * @return Payload length in words
+ */
+static inline __attribute__((always_inline))
+U32 ww_log_payload_plain(U32 *payload, const U32 *params, U32 param_count)
+{
+    U32 pos = 0;
+    U32 i;
+
+    ww_log_payload_begin(payload, &pos);
+    for (i = 0; i < param_count; i++) {
+        ww_log_payload_put(payload, &pos, WW_LOG_TAG_U32, params[i]);
+    }
+    return ww_log_payload_finish(payload, pos);
+}
+#endif
+
+/**
+ * @brief Write a record of plain 32-bit parameters
+ * @param encoded_log Record header (DATA_LEN = param_count)
+ * @param params Parameters
+ * @param param_count Number of parameters
+ *
+ * Without WW_LOG_ENCODE_COMPACT or WW_LOG_ENCODE_TIMESTAMP_EN the
+ * parameters are the payload; otherwise the payload is built first
+ * (timestamp item, packed parameters) and DATA_LEN is set to its word count.
+ */
+static inline __attribute__((always_inline))
+void ww_log_encode_write(WW_LOG_HDR_T encoded_log, const U32 *params, U32 param_count)
+{
+#if defined(WW_LOG_ENCODE_COMPACT) || defined(WW_LOG_ENCODE_TIMESTAMP_EN)
+    U32 payload[WW_LOG_PLAIN_PAYLOAD_WORDS];
+    U32 words = ww_log_payload_plain(payload, params, param_count);
+
+    ww_log_encode_emit(WW_LOG_ENCODE_SET_DATA_LEN(encoded_log, words), payload, words);
+#else
+    ww_log_encode_emit(encoded_log, params, param_count);
+#endif
+}
+
 /**
  * @brief Core encode mode output function (variadic version)
- * @param module_id Module ID (0-31) for filtering
- * @param log_id File identifier (12 bits, 0-4095)
+ * @param module_id Module ID for filtering (implied by log_id)
+ * @param log_id File identifier (below WW_LOG_FILE_ID_LIMIT)
  * @param line Source line number
  * @param level Log level (0-3)
  * @param param_count Number of parameters (0-16)
  * @param ... Variable parameters (each as U32)
  *
  * This function performs all filtering internally to minimize code size
- * at each call site. Filtering checks:
- * 1. Module enable check (via g_ww_log_module_mask)
- * 2. Level threshold check (via g_ww_log_level_threshold)
- *
- * Parameters are extracted via va_list and stored in a local array,
- * then used for both RAM buffer and UART output.
+ * at each call site. Only used by LOG_XXX() for more than 4 parameters;
+ * see ww_log_encode_output0..4() for the common case.
  */
-void ww_log_encode_output(U8 module_id, U16 log_id, U16 line, U8 level,
+void ww_log_encode_output(U16 module_id, U16 log_id, U32 line, U8 level,
                 U8 param_count, ...)
 {
-    U32 encoded_log;
+    U32 params[16];
     va_list args;
-    U32 params[16];  /* Support up to 16 parameters */
     U8 i;
 
-    /* Check module enable (dynamic switch) */
-    if ((g_ww_log_module_mask & (1U << module_id)) == 0) {
+    (void)module_id;  /* Implied by log_id */
+    if (!ww_log_encode_enabled(log_id, level)) {
         return;
     }
 
-    /* Check level threshold (dynamic switch) */
-    if (level > g_ww_log_level_threshold) {
+    /* Limit param_count for safety */
+    if (param_count > 16) {
+        param_count = 16;
+    }
+
+    /* Extract variadic parameters */
+    va_start(args, param_count);
+    for (i = 0; i < param_count; i++) {
+        params[i] = va_arg(args, U32);
+    }
+    va_end(args);
+
+    ww_log_encode_write(WW_LOG_ENCODE(log_id, line, param_count, level), params, param_count);
+}
+
+/* ========== Control Records ========== */
+
+/**
+ * @brief Write a control record
+ *
+ * Control records bypass the module and level switches and keep their
+ * payload as plain words.
+ */
+S8 ww_log_encode_control(U16 type, const U32 *words, U32 count)
+{
+    return ww_log_encode_emit(WW_LOG_ENCODE(WW_LOG_CTRL_LOG_ID, type, count, WW_LOG_LEVEL_DBG),
+                              words, count);
+}
+
+/**
+ * Filter on the LOG_ID (file) and level fields of a complete header
+ */
+#define WW_LOG_ENCODE_HDR_ENABLED(header) \
+    ww_log_encode_enabled(WW_LOG_DECODE_LOG_ID(header), WW_LOG_DECODE_LEVEL(header))
+
+/**
+ * @brief Report the records suppressed by a call site's rate limit
+ *
+ * Payload: [site header words][records suppressed]
+ */
+void ww_log_encode_suppressed(WW_LOG_HDR_T header, U32 *suppressed)
+{
+    U32 words[WW_LOG_HDR_WORDS + 1];
+    U32 i;
+
+    if (!WW_LOG_ENCODE_HDR_ENABLED(header)) {
         return;
     }
 
+    for (i = 0; i < WW_LOG_HDR_WORDS; i++) {
+        words[i] = WW_LOG_HDR_WORD(header, i);
+    }
+    words[WW_LOG_HDR_WORDS] = __atomic_exchange_n(suppressed, 0, __ATOMIC_RELAXED);
+    if (words[WW_LOG_HDR_WORDS] != 0) {
+        ww_log_encode_control(WW_LOG_CTRL_SUPPRESS, words, WW_LOG_HDR_WORDS + 1);
+    }
+}
+
+/* ========== Fixed-Arity Output Functions ========== */
+
+void ww_log_encode_output0(WW_LOG_HDR_T header)
+{
+    if (WW_LOG_ENCODE_HDR_ENABLED(header)) {
+        ww_log_encode_write(header, NULL, 0);
+    }
+}
+
+void ww_log_encode_output1(WW_LOG_HDR_T header, U32 p0)
+{
+    if (WW_LOG_ENCODE_HDR_ENABLED(header)) {
+        U32 params[1] = { p0 };
+        ww_log_encode_write(header, params, 1);
+    }
+}
+
+void ww_log_encode_output2(WW_LOG_HDR_T header, U32 p0, U32 p1)
+{
+    if (WW_LOG_ENCODE_HDR_ENABLED(header)) {
+        U32 params[2] = { p0, p1 };
+        ww_log_encode_write(header, params, 2);
+    }
+}
+
+void ww_log_encode_output3(WW_LOG_HDR_T header, U32 p0, U32 p1, U32 p2)
+{
+    if (WW_LOG_ENCODE_HDR_ENABLED(header)) {
+        U32 params[3] = { p0, p1, p2 };
+        ww_log_encode_write(header, params, 3);
+    }
+}
+
+void ww_log_encode_output4(WW_LOG_HDR_T header, U32 p0, U32 p1, U32 p2, U32 p3)
+{
+    if (WW_LOG_ENCODE_HDR_ENABLED(header)) {
+        U32 params[4] = { p0, p1, p2, p3 };
+        ww_log_encode_write(header, params, 4);
+    }
+}
+
+/* ========== Typed Output Function ========== */
+
+/**
+ * @brief Build the payload of a typed record
+ * @param payload Payload buffer (WW_LOG_PAYLOAD_WORDS)
+ * @param param_count Number of parameters
+ * @param tags Type tags, WW_LOG_TAG_BITS per parameter
+ * @param args Parameters as passed by LOG_XXX()
+ * @return Payload length in words
+ *
+ * Builds [timestamp][descriptor words][values] (see WW_LOG_ENCODE_EXT_FLAG,
+ * WW_LOG_TAG_STR and ww_log_time.h).
+ */
+static U32 ww_log_payload_ext(U32 *payload, U32 param_count, U64 tags, va_list args)
+{
+    U32 desc_words;
+    U32 pos = 0;
+    U32 i;
+
     /* Limit param_count for safety */
     if (param_count > 16) {
         param_count = 16;
     }
 
-    /* Extract variadic parameters into array */
-    if (param_count > 0) {
-        va_start(args, param_count);
-        for (i = 0; i < param_count; i++) {
-            params[i] = va_arg(args, U32);
+    ww_log_payload_begin(payload, &pos);
+
+    /* Descriptor words: 10 tags each, bit 31 chains to the next word */
+    desc_words = (param_count + WW_LOG_EXT_TAGS_PER_WORD - 1) / WW_LOG_EXT_TAGS_PER_WORD;
+    for (i = 0; i < desc_words; i++) {
+        U32 desc = (U32)(tags >> (i * WW_LOG_EXT_TAGS_PER_WORD * WW_LOG_TAG_BITS)) &
+                   ((1U << (WW_LOG_EXT_TAGS_PER_WORD * WW_LOG_TAG_BITS)) - 1);
+
+        if (i + 1 < desc_words) {
+            desc |= WW_LOG_EXT_DESC_MORE;
         }
-        va_end(args);
+        ww_log_payload_put(payload, &pos, WW_LOG_TAG_PTR32, desc);  /* Unsigned word */
     }
 
-    /* Encode the log entry */
-    encoded_log = WW_LOG_ENCODE(log_id, line, param_count, level);
+    /* Values at their full width */
+    for (i = 0; i < param_count; i++) {
+        U32 tag = (U32)(tags >> (i * WW_LOG_TAG_BITS)) & ((1U << WW_LOG_TAG_BITS) - 1);
+        U64 value;
+
+        switch (tag) {
+        case WW_LOG_TAG_U64:
+            value = va_arg(args, unsigned long long);
+            break;
+        case WW_LOG_TAG_F32: {
+            float f = (float)va_arg(args, double);
+            U32 bits;
+
+            memcpy(&bits, &f, sizeof(bits));
+            value = bits;
+            break;
+        }
+        case WW_LOG_TAG_F64: {
+            double d = va_arg(args, double);
 
-    /* Output to UART as hex for debugging/decoding */
-    /* Format: 0xHHHHHHHH 0xPPPPPPPP 0xPPPPPPPP ... */
-    printf("0x%08X", encoded_log);
+            memcpy(&value, &d, sizeof(value));
+            break;
+        }
+        case WW_LOG_TAG_PTR32:
+        case WW_LOG_TAG_PTR64:
+            value = (uintptr_t)va_arg(args, void *);
+            break;
+        case WW_LOG_TAG_STR:
+            ww_log_payload_put_str(payload, &pos, va_arg(args, const char *),
+                                   (param_count - 1 - i) * WW_LOG_ITEM_MAX_BYTES);
+            continue;
+        default:
+            value = va_arg(args, U32);
+            break;
+        }
 
-    /* Print all parameters */
+        ww_log_payload_put(payload, &pos, tag, value);
+    }
+
+    return ww_log_payload_finish(payload, pos);
+}
+
+/**
+ * @brief Output function for typed records
+ * @param header WW_LOG_ENCODE(log_id, line, param_count, level)
+ * @param tags Type tags, WW_LOG_TAG_BITS per parameter
+ * @param ... Parameters as passed by LOG_XXX()
+ *
+ * Writes the payload of ww_log_payload_ext() as one record with the typed
+ * flag set (WW_LOG_ENCODE_SET_EXT).
+ */
+void ww_log_encode_output_ext(WW_LOG_HDR_T header, U64 tags, ...)
+{
+    U32 payload[WW_LOG_PAYLOAD_WORDS];
+    U32 words;
+    va_list args;
+
+    if (!WW_LOG_ENCODE_HDR_ENABLED(header)) {
+        return;
+    }
+
+    va_start(args, tags);
+    words = ww_log_payload_ext(payload, WW_LOG_DECODE_DATA_LEN(header), tags, args);
+    va_end(args);
+
+    header = WW_LOG_ENCODE_SET_DATA_LEN(WW_LOG_ENCODE_SET_EXT(header), words);
+    ww_log_encode_emit(header, payload, words);
+}
+
+
+/* ========== Data Block Output ========== */
+
+/**
+ * @brief Write one blob record
+ * @param header Record header with the typed flag set
+ * @param offset Offset of the chunk in the block
+ * @param total Length of the block
+ * @param bytes Chunk bytes
+ * @param chunk Chunk length (at most WW_LOG_BLOB_CHUNK_MAX)
+ *
+ * With the RAM buffer enabled, the bytes are copied straight into the
+ * reserved ring slots (two runs when the record wraps) instead of being
+ * staged in a payload buffer first.
+ */
+static void ww_log_encode_blob(WW_LOG_HDR_T header, U32 offset, U32 total, const U8 *bytes, U32 chunk)
+{
+    U32 payload[4 + WW_LOG_BLOB_CHUNK_MAX / 4];
+    U32 pos = 0;
+    U32 prefix;
+    U32 words;
+
+    ww_log_payload_begin(payload, &pos);
+    ww_log_payload_put(payload, &pos, WW_LOG_TAG_PTR32, WW_LOG_BLOB_DESC(offset, chunk));
+    ww_log_payload_put(payload, &pos, WW_LOG_TAG_PTR32, total);
+    prefix = ww_log_payload_finish(payload, pos);
+    words = prefix + (chunk + 3) / 4;
+    header = WW_LOG_ENCODE_SET_DATA_LEN(header, words);
+
+#ifdef WW_LOG_RAM_BUFFER_EN
+    {
+        U32 start;
+        U32 first;
+        U32 i;
+
+        if (ww_log_ram_reserve(WW_LOG_HDR_WORDS + words, &start) != 0) {
+            return;  /* Buffer full - drop new record */
+        }
+
+        for (i = 1; i < WW_LOG_HDR_WORDS; i++) {
+            WW_LOG_RAM_SLOT(start + i) = WW_LOG_HDR_WORD(header, i);
+        }
+        for (i = 0; i < prefix; i++) {
+            WW_LOG_RAM_SLOT(start + WW_LOG_HDR_WORDS + i) = payload[i];
+        }
+
+        /* Bytes up to the end of the ring, the rest from slot 0 */
+        pos = (start + WW_LOG_HDR_WORDS + prefix) & (WW_LOG_RAM_BUFFER_SIZE - 1);
+        first = (WW_LOG_RAM_BUFFER_SIZE - pos) * 4;
+        if (first > chunk) {
+            first = chunk;
+        }
+        ww_log_blob_copy(&g_ww_log_ram_buffer.entries[pos], bytes, first);
+        ww_log_blob_copy(&g_ww_log_ram_buffer.entries[0], &bytes[first], chunk - first);
+
+        ww_log_ram_commit(start, WW_LOG_HDR_WORD(header, 0));
+#ifdef WW_LOG_ASYNC_EN
+        ww_log_async_notify(start + WW_LOG_HDR_WORDS + words, WW_LOG_DECODE_LEVEL(header));
+#endif
+    }
+#else
+    ww_log_blob_copy(&payload[prefix], bytes, chunk);
+    ww_log_encode_emit(header, payload, words);
+#endif /* WW_LOG_RAM_BUFFER_EN */
+}
+
+/**
+ * @brief Output function for data blocks
+ * @param header WW_LOG_ENCODE(log_id, line, 0, level)
+ * @param data Bytes to log
+ * @param len Number of bytes
+ *
+ * Splits the block into WW_LOG_BLOB_CHUNK_MAX byte chunks, one record
+ * each (see WW_LOG_TAG_BLOB). An empty block is one record without bytes.
+ */
+void ww_log_encode_hex(WW_LOG_HDR_T header, const void *data, U32 len)
+{
+    const U8 *bytes = (const U8 *)data;
+    U32 offset = 0;
+
+    if (!WW_LOG_ENCODE_HDR_ENABLED(header)) {
+        return;
+    }
+
+    if (bytes == NULL) {
+        len = 0;
+    }
+    if (len > WW_LOG_BLOB_MAX_LEN) {
+        len = WW_LOG_BLOB_MAX_LEN;
+    }
+
+    header = WW_LOG_ENCODE_SET_EXT(header);
+
+    do {
+        U32 chunk = len - offset;
+
+        if (chunk > WW_LOG_BLOB_CHUNK_MAX) {
+            chunk = WW_LOG_BLOB_CHUNK_MAX;
+        }
+        ww_log_encode_blob(header, offset, len, &bytes[offset], chunk);
+        offset += chunk;
+    } while (offset < len);
+}
+
+/* ========== Batched Records ========== */
+
+/**
+ * @brief Start a batch and check the filter for it
+ */
+void ww_log_encode_batch_begin(WW_LOG_BATCH_T *batch, WW_LOG_HDR_T header)
+{
+    batch->used = 0;
+    batch->records = 0;
+    batch->dropped = 0;
+    batch->level = (U8)WW_LOG_DECODE_LEVEL(header);
+    batch->enabled = WW_LOG_ENCODE_HDR_ENABLED(header);
+}
+
+/**
+ * @brief Append one record to a batch
+ * @param header Record header (DATA_LEN = words)
+ * @param payload Payload words
+ * @param words Number of payload words
+ */
+static void ww_log_batch_put(WW_LOG_BATCH_T *batch, WW_LOG_HDR_T header,
+                             const U32 *payload, U32 words)
+{
+    U32 *rec = &batch->words[batch->used];
+    U32 i;
+
+    if (batch->used + WW_LOG_HDR_WORDS + words > WW_LOG_BATCH_WORDS) {
+        batch->dropped++;
+        return;
+    }
+
+    for (i = 0; i < WW_LOG_HDR_WORDS; i++) {
+        rec[i] = WW_LOG_HDR_WORD(header, i);
+    }
+    for (i = 0; i < words; i++) {
+        rec[WW_LOG_HDR_WORDS + i] = payload[i];
+    }
+    batch->used += WW_LOG_HDR_WORDS + words;
+    batch->records++;
+}
+
+/**
+ * @brief Add a record of plain 32-bit parameters to a batch
+ */
+void ww_log_encode_batch_add(WW_LOG_BATCH_T *batch, WW_LOG_HDR_T header, ...)
+{
+    U32 params[16];
+    U32 param_count = WW_LOG_DECODE_DATA_LEN(header);
+    va_list args;
+    U32 i;
+
+    /* Limit param_count for safety */
+    if (param_count > 16) {
+        param_count = 16;
+    }
+
+    va_start(args, header);
     for (i = 0; i < param_count; i++) {
-        printf(" 0x%08X", params[i]);
+        params[i] = va_arg(args, U32);
+    }
+    va_end(args);
+
+#if defined(WW_LOG_ENCODE_COMPACT) || defined(WW_LOG_ENCODE_TIMESTAMP_EN)
+    {
+        U32 payload[WW_LOG_PLAIN_PAYLOAD_WORDS];
+        U32 words = ww_log_payload_plain(payload, params, param_count);
+
+        ww_log_batch_put(batch, WW_LOG_ENCODE_SET_DATA_LEN(header, words), payload, words);
+    }
+#else
+    ww_log_batch_put(batch, header, params, param_count);
+#endif
+}
+
+/**
+ * @brief Add a typed record to a batch
+ */
+void ww_log_encode_batch_add_ext(WW_LOG_BATCH_T *batch, WW_LOG_HDR_T header, U64 tags, ...)
+{
+    U32 payload[WW_LOG_PAYLOAD_WORDS];
+    U32 words;
+    va_list args;
+
+    va_start(args, tags);
+    words = ww_log_payload_ext(payload, WW_LOG_DECODE_DATA_LEN(header), tags, args);
+    va_end(args);
+
+    header = WW_LOG_ENCODE_SET_DATA_LEN(WW_LOG_ENCODE_SET_EXT(header), words);
+    ww_log_batch_put(batch, header, payload, words);
+}
+
+/**
+ * @brief Write all records of a batch
+ *
+ * RAM ring: one reservation for all records; every slot but the first
+ * header is filled before that header is published. Direct output: the
+ * records are rendered into one buffer and written with one sink write.
+ */
+void ww_log_encode_batch_commit(WW_LOG_BATCH_T *batch)
+{
+    U32 *words = batch->words;
+    U32 used = batch->used;
+    U32 records = batch->records;
+    U32 i;
+
+    /* Records left out: a drop record closes the batch */
+    if (batch->dropped != 0) {
+        WW_LOG_HDR_T drop = WW_LOG_ENCODE(WW_LOG_CTRL_LOG_ID, WW_LOG_CTRL_DROP, 1,
+                                          WW_LOG_LEVEL_WRN);
+
+        for (i = 0; i < WW_LOG_HDR_WORDS; i++) {
+            words[used + i] = WW_LOG_HDR_WORD(drop, i);
+        }
+        words[used + WW_LOG_HDR_WORDS] = batch->dropped;
+        used += WW_LOG_BATCH_DROP_WORDS;
+        records++;
     }
 
-    printf("\n");
-    fflush(stdout);
+    if (records == 0) {
+        return;
+    }
+
+#ifdef WW_LOG_RAM_BUFFER_EN
+    {
+        U32 pos;
+
+        if (ww_log_ram_reserve_batch(used, records, &pos) != 0) {
+            return;  /* Buffer full - drop the whole batch */
+        }
+
+        for (i = 1; i < used; i++) {
+            WW_LOG_RAM_SLOT(pos + i) = words[i];
+        }
+
+        ww_log_ram_commit(pos, words[0]);
+#ifdef WW_LOG_ASYNC_EN
+        ww_log_async_notify(pos + used, batch->level);
+#endif
+    }
+#else
+    {
+        char out[(WW_LOG_BATCH_WORDS + WW_LOG_BATCH_DROP_WORDS) * 12 + WW_LOG_SYNC_FRAME_TEXT];
+        U32 len = 0;
+
+#ifdef WW_LOG_ENCODE_SYNC_EN
+        ww_log_sync_lock();  /* Block CRC follows the output order */
+#endif
+        for (i = 0; i < used; i += WW_LOG_REC_WORDS(words[i])) {
+            len += ww_log_encode_render(&words[i], &out[len], sizeof(out) - len);
+        }
+        ww_log_sink_write(out, len);
+#ifdef WW_LOG_ENCODE_SYNC_EN
+        ww_log_sync_unlock();
+#endif
+
+#ifndef WW_LOG_ENCODE_OUTPUT_BIN
+        ww_log_sink_flush();
+#endif
+    }
+#endif /* WW_LOG_RAM_BUFFER_EN */
 }
 
 #endif /* WW_LOG_MODE_ENCODE */
@@ -1,18 +1,115 @@
 /**
  * @file ww_log_modules.c
- * @brief Module mask management implementation
+ * @brief Runtime configuration: module mask, level thresholds, sink selection
  * @date 2025-12-01
+ *
+ * Every setter is a small update transaction: ww_log_config_begin() locks
+ * and copies the current snapshot into the next slot, the setter changes
+ * the copy, ww_log_config_commit() rebuilds the level table and publishes
+ * the slot with one pointer store. Concurrent setters are serialized by
+ * the lock, so read-modify-write updates (enable/disable module) cannot
+ * lose each other's changes.
+ *
+ * A slot is rewritten WW_LOG_CONFIG_SLOTS - 1 commits after it was
+ * replaced. Its seq is odd during the rewrite (seqlock), which lets
+ * ww_log_config_read() detect a copy that raced with one.
  */
 
 #include "ww_log_modules.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Part of WW_LOG_CONFIG_T after seq (copied between slots) */
+#define WW_LOG_CONFIG_BODY  offsetof(WW_LOG_CONFIG_T, version)
 
 /* ========== Global Variables ========== */
 
 /**
- * Module mask - each bit controls one module (0-31)
- * Default: 0xFFFFFFFF (all modules enabled)
+ * Snapshot slots; slot 0 is the default configuration:
+ * all modules and sinks enabled, all thresholds DBG (4 levels pass)
+ */
+static WW_LOG_CONFIG_T g_config_slots[WW_LOG_CONFIG_SLOTS] = {
+    [0] = {
+        .seq = 0,
+        .version = 0,
+        .module_mask = { [0 ... WW_LOG_MODULE_WORDS - 1] = 0xFFFFFFFF },
+        .sink_mask = 0xFFFFFFFF,
+        .level_threshold = 3,  /* WW_LOG_LEVEL_DBG */
+        .module_level = { [0 ... WW_LOG_MODULE_MAX - 1] = 3 },
+        .level_table = { [0 ... WW_LOG_FILE_ID_MAX - 1] = 4 },
+    },
+};
+
+WW_LOG_CONFIG_T *g_ww_log_config = &g_config_slots[0];
+
+/* Serializes updates (begin .. commit) */
+static pthread_mutex_t g_config_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ========== Update Transactions ========== */
+
+/**
+ * @brief Start a configuration update
+ */
+WW_LOG_CONFIG_T *ww_log_config_begin(void)
+{
+    WW_LOG_CONFIG_T *cur;
+    WW_LOG_CONFIG_T *next;
+
+    pthread_mutex_lock(&g_config_lock);
+
+    cur = g_ww_log_config;
+    next = &g_config_slots[(cur - g_config_slots + 1) % WW_LOG_CONFIG_SLOTS];
+
+    __atomic_store_n(&next->seq, next->seq + 1, __ATOMIC_RELAXED);  /* Odd */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy((U8 *)next + WW_LOG_CONFIG_BODY, (const U8 *)cur + WW_LOG_CONFIG_BODY,
+           sizeof(*cur) - WW_LOG_CONFIG_BODY);
+    return next;
+}
+
+/**
+ * @brief Rebuild the level table and publish the update
+ */
+void ww_log_config_commit(WW_LOG_CONFIG_T *cfg)
+{
+    U32 i;
+
+    for (i = 0; i < WW_LOG_FILE_ID_MAX; i++) {
+        U16 module_id = i / WW_LOG_FILES_PER_MODULE;
+
+        if (!WW_LOG_MODULE_BIT(cfg->module_mask, module_id)) {
+            cfg->level_table[i] = 0;
+        } else if (cfg->file_level[i] != 0) {
+            cfg->level_table[i] = cfg->file_level[i];
+        } else {
+            cfg->level_table[i] = cfg->module_level[module_id] + 1;
+        }
+    }
+    cfg->version++;
+
+    __atomic_store_n(&cfg->seq, cfg->seq + 1, __ATOMIC_RELEASE);  /* Even */
+    __atomic_store_n(&g_ww_log_config, cfg, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_config_lock);
+}
+
+/**
+ * @brief Copy a consistent configuration snapshot
  */
-U32 g_ww_log_module_mask = 0xFFFFFFFF;
+void ww_log_config_read(WW_LOG_CONFIG_T *out)
+{
+    const WW_LOG_CONFIG_T *cfg;
+    U32 seq;
+
+    do {
+        cfg = __atomic_load_n(&g_ww_log_config, __ATOMIC_ACQUIRE);
+        seq = __atomic_load_n(&cfg->seq, __ATOMIC_ACQUIRE);
+        memcpy(out, cfg, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1U) != 0 || __atomic_load_n(&cfg->seq, __ATOMIC_RELAXED) != seq);
+
+    out->seq = seq;
+}
 
 /* ========== API Implementation ========== */
 
@@ -21,7 +118,10 @@ U32 g_ww_log_module_mask = 0xFFFFFFFF;
  */
 void ww_log_set_module_mask(U32 mask)
 {
-    g_ww_log_module_mask = mask;
+    WW_LOG_CONFIG_T *cfg = ww_log_config_begin();
+
+    cfg->module_mask[0] = mask;
+    ww_log_config_commit(cfg);
 }
 
 /**
@@ -29,55 +129,65 @@ void ww_log_set_module_mask(U32 mask)
  */
 U32 ww_log_get_module_mask(void)
 {
-    return g_ww_log_module_mask;
+    return ww_log_config_current()->module_mask[0];
 }
 
 /**
  * @brief Enable a specific module
  */
-void ww_log_enable_module(U8 module_id)
+void ww_log_enable_module(U16 module_id)
 {
+    WW_LOG_CONFIG_T *cfg;
+
     if (module_id < WW_LOG_MODULE_MAX) {
-        g_ww_log_module_mask |= (1U << module_id);
+        cfg = ww_log_config_begin();
+        cfg->module_mask[module_id >> 5] |= (1U << (module_id & 31));
+        ww_log_config_commit(cfg);
     }
 }
 
 /**
  * @brief Disable a specific module
  */
-void ww_log_disable_module(U8 module_id)
+void ww_log_disable_module(U16 module_id)
 {
+    WW_LOG_CONFIG_T *cfg;
+
     if (module_id < WW_LOG_MODULE_MAX) {
-        g_ww_log_module_mask &= ~(1U << module_id);
+        cfg = ww_log_config_begin();
+        cfg->module_mask[module_id >> 5] &= ~(1U << (module_id & 31));
+        ww_log_config_commit(cfg);
     }
 }
 
 /**
  * @brief Check if a specific module is enabled
  */
-U8 ww_log_is_module_enabled(U8 module_id)
+U8 ww_log_is_module_enabled(U16 module_id)
 {
     if (module_id >= WW_LOG_MODULE_MAX) {
         return 0;
     }
-    return (g_ww_log_module_mask & (1U << module_id)) ? 1 : 0;
+    return (U8)WW_LOG_MODULE_BIT(ww_log_config_current()->module_mask, module_id);
 }
 
 /* ========== Level Threshold Control ========== */
 
 /**
- * Global log level threshold
- * Default: WW_LOG_LEVEL_DBG (3) = allow all logs
- */
-U8 g_ww_log_level_threshold = 3;  /* WW_LOG_LEVEL_DBG */
-
-/**
- * @brief Set global log level threshold
+ * @brief Set global log level threshold (and that of every module)
  */
 void ww_log_set_level_threshold(U8 level)
 {
+    WW_LOG_CONFIG_T *cfg;
+    U16 i;
+
     if (level <= 3) {  /* WW_LOG_LEVEL_DBG */
-        g_ww_log_level_threshold = level;
+        cfg = ww_log_config_begin();
+        cfg->level_threshold = level;
+        for (i = 0; i < WW_LOG_MODULE_MAX; i++) {
+            cfg->module_level[i] = level;
+        }
+        ww_log_config_commit(cfg);
     }
 }
 
@@ -86,5 +196,97 @@ void ww_log_set_level_threshold(U8 level)
  */
 U8 ww_log_get_level_threshold(void)
 {
-    return g_ww_log_level_threshold;
+    return ww_log_config_current()->level_threshold;
+}
+
+/**
+ * @brief Set the level threshold of one module
+ */
+void ww_log_set_module_level(U16 module_id, U8 level)
+{
+    WW_LOG_CONFIG_T *cfg;
+
+    if (module_id < WW_LOG_MODULE_MAX && level <= 3) {  /* WW_LOG_LEVEL_DBG */
+        cfg = ww_log_config_begin();
+        cfg->module_level[module_id] = level;
+        ww_log_config_commit(cfg);
+    }
+}
+
+/**
+ * @brief Get the level threshold of one module
+ */
+U8 ww_log_get_module_level(U16 module_id)
+{
+    const WW_LOG_CONFIG_T *cfg = ww_log_config_current();
+
+    if (module_id >= WW_LOG_MODULE_MAX) {
+        return cfg->level_threshold;
+    }
+    return cfg->module_level[module_id];
+}
+
+/**
+ * @brief Override the level threshold of one file
+ */
+void ww_log_set_file_level(U16 file_id, U8 level)
+{
+    WW_LOG_CONFIG_T *cfg;
+
+    if (file_id < WW_LOG_FILE_ID_MAX && level <= 3) {  /* WW_LOG_LEVEL_DBG */
+        cfg = ww_log_config_begin();
+        cfg->file_level[file_id] = level + 1;
+        ww_log_config_commit(cfg);
+    }
+}
+
+/**
+ * @brief Remove the level override of one file
+ */
+void ww_log_clear_file_level(U16 file_id)
+{
+    WW_LOG_CONFIG_T *cfg;
+
+    if (file_id < WW_LOG_FILE_ID_MAX) {
+        cfg = ww_log_config_begin();
+        cfg->file_level[file_id] = 0;
+        ww_log_config_commit(cfg);
+    }
+}
+
+/**
+ * @brief Get the level threshold in effect for one file
+ */
+U8 ww_log_get_file_level(U16 file_id)
+{
+    const WW_LOG_CONFIG_T *cfg = ww_log_config_current();
+
+    if (file_id >= WW_LOG_FILE_ID_MAX) {
+        return cfg->level_threshold;
+    }
+    if (cfg->file_level[file_id] != 0) {
+        return cfg->file_level[file_id] - 1;
+    }
+    return cfg->module_level[file_id / WW_LOG_FILES_PER_MODULE];
+}
+
+/* ========== Sink Selection ========== */
+
+/**
+ * @brief Select the registered sinks that receive output
+ */
+void ww_log_set_sink_mask(U32 mask)
+{
+    WW_LOG_CONFIG_T *cfg = ww_log_config_begin();
+
+    cfg->sink_mask = mask;
+    ww_log_config_commit(cfg);
+}
+
+/**
+ * @brief Get the sink selection
+ */
+U32 ww_log_get_sink_mask(void)
+{
+    return ww_log_config_current()->sink_mask;
 }
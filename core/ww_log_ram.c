@@ -0,0 +1,537 @@
+/**
+ * @file ww_log_ram.c
+ * @brief Lock-free multi-producer RAM ring buffer implementation
+ * @date 2026-10-16
+ *
+ * Synchronization uses the GCC __atomic builtins so the buffer layout stays
+ * a plain struct of U32 words (no _Atomic qualifiers).
+ */
+
+#include "ww_log.h"
+#include <string.h>
+
+#ifdef WW_LOG_RAM_BUFFER_EN
+
+#ifdef WW_LOG_RAM_OVERWRITE_EN
+#include <pthread.h>
+#endif
+
+/**
+ * Global RAM buffer instance
+ * (WW_LOG_RAM_PERSIST_EN: the boot ring, used until the file is mapped)
+ */
+#ifdef WW_LOG_RAM_PERSIST_EN
+WW_LOG_RAM_BUFFER_T g_ww_log_ram_boot = {
+#else
+WW_LOG_RAM_BUFFER_T g_ww_log_ram_buffer = {
+#endif
+    .magic = WW_LOG_RAM_MAGIC,
+    .version = WW_LOG_RAM_LAYOUT_VERSION,
+    .size = WW_LOG_RAM_BUFFER_SIZE,
+    .head = 0,
+    .records_out = 0,
+    .tail = 0,
+    .records_in = 0,
+    .words_in = 0,
+    .dropped = 0,
+    .drops_pending = 0,
+    .high_water = 0,
+    .overwritten = 0,
+    .entries = {0}
+};
+
+#ifdef WW_LOG_RAM_OVERWRITE_EN
+/**
+ * Serializes reservation + eviction (producers only, held for a few loads
+ * and stores)
+ */
+static pthread_mutex_t g_reserve_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ========== Internal Functions ========== */
+
+#ifdef WW_LOG_RAM_OVERWRITE_EN
+/**
+ * @brief Claim 'words' words at the tail, evicting the oldest records
+ * @return 0 on success, -1 if the oldest record is still being written
+ */
+static S8 ww_log_ram_claim_tail(U32 words, U32 *start, U32 *head_out)
+{
+    U32 evicted = 0;
+    U32 tail;
+    U32 head;
+
+    if (words > WW_LOG_RAM_BUFFER_SIZE) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_reserve_lock);
+
+    tail = __atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_RELAXED);
+    head = __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_ACQUIRE);
+
+    /* head < tail inside the loop, so slot(head) is a zeroed or published header */
+    while ((U32)(tail + words - head) > WW_LOG_RAM_BUFFER_SIZE) {
+        U32 header = __atomic_load_n(&WW_LOG_RAM_SLOT(head), __ATOMIC_ACQUIRE);
+
+        if (header == 0) {
+            pthread_mutex_unlock(&g_reserve_lock);
+            if (evicted != 0) {
+                __atomic_fetch_add(&g_ww_log_ram_buffer.records_out, evicted, __ATOMIC_RELAXED);
+                __atomic_fetch_add(&g_ww_log_ram_buffer.overwritten, evicted, __ATOMIC_RELAXED);
+            }
+            return -1;
+        }
+
+        /* A failed CAS means a reader moved 'head'; retry from there */
+        if (__atomic_compare_exchange_n(&g_ww_log_ram_buffer.head, &head,
+                                        head + WW_LOG_RAM_REC_WORDS(header), 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            head += WW_LOG_RAM_REC_WORDS(header);
+            evicted++;
+        }
+    }
+
+    /* The slot may hold a word of an evicted record: unpublished reads as 0 */
+    __atomic_store_n(&WW_LOG_RAM_SLOT(tail), 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_ww_log_ram_buffer.tail, tail + words, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&g_reserve_lock);
+
+    if (evicted != 0) {
+        __atomic_fetch_add(&g_ww_log_ram_buffer.records_out, evicted, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&g_ww_log_ram_buffer.overwritten, evicted, __ATOMIC_RELAXED);
+    }
+
+    *start = tail;
+    *head_out = head;
+    return 0;
+}
+#else
+/**
+ * @brief Claim 'words' words at the tail
+ * @return 0 on success, -1 if they do not fit
+ */
+static S8 ww_log_ram_claim_tail(U32 words, U32 *start, U32 *head_out)
+{
+    U32 tail = __atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_RELAXED);
+    U32 head;
+
+    do {
+        head = __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_ACQUIRE);
+        if ((U32)(tail + words - head) > WW_LOG_RAM_BUFFER_SIZE) {
+            return -1;
+        }
+    } while (!__atomic_compare_exchange_n(&g_ww_log_ram_buffer.tail,
+                                          &tail, tail + words, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    *start = tail;
+    *head_out = head;
+    return 0;
+}
+#endif /* WW_LOG_RAM_OVERWRITE_EN */
+
+/**
+ * @brief Claim 'words' words for 'records' records and update the counters
+ * @return 0 on success, -1 if the space cannot be claimed
+ */
+static S8 ww_log_ram_claim(U32 words, U32 records, U32 *pos)
+{
+    U32 start;
+    U32 head;
+    U32 used;
+    U32 high;
+
+    if (ww_log_ram_claim_tail(words, &start, &head) != 0) {
+        return -1;
+    }
+
+    /* Counters share the cache line of 'tail', which this thread now owns */
+    __atomic_fetch_add(&g_ww_log_ram_buffer.records_in, records, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_ww_log_ram_buffer.words_in, words, __ATOMIC_RELAXED);
+
+    used = start + words - head;
+    high = __atomic_load_n(&g_ww_log_ram_buffer.high_water, __ATOMIC_RELAXED);
+    while (used > high &&
+           !__atomic_compare_exchange_n(&g_ww_log_ram_buffer.high_water, &high, used, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    *pos = start;
+    return 0;
+}
+
+/**
+ * @brief Count a dropped record
+ */
+static void ww_log_ram_count_drop(U32 records)
+{
+    __atomic_fetch_add(&g_ww_log_ram_buffer.dropped, records, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_ww_log_ram_buffer.drops_pending, records, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Write a drop marker at 'pos' and publish it
+ */
+static void ww_log_ram_put_marker(U32 pos, U32 dropped)
+{
+#if WW_LOG_RAM_DROP_WORDS == 3
+    WW_LOG_RAM_SLOT(pos + 1) = 3;  /* v2 LINE word: WW_LOG_CTRL_DROP */
+#endif
+    WW_LOG_RAM_SLOT(pos + WW_LOG_RAM_DROP_WORDS - 1) = dropped;
+    ww_log_ram_commit(pos, WW_LOG_RAM_DROP_HDR);
+}
+
+/**
+ * @brief Write the pending drop count as a marker of its own
+ *
+ * Used by the consumer, so drops are reported even when no producer
+ * writes afterwards (e.g. at shutdown).
+ */
+static void ww_log_ram_flush_drops(void)
+{
+    U32 dropped;
+    U32 pos;
+
+    if (__atomic_load_n(&g_ww_log_ram_buffer.drops_pending, __ATOMIC_RELAXED) == 0) {
+        return;
+    }
+
+    dropped = __atomic_exchange_n(&g_ww_log_ram_buffer.drops_pending, 0, __ATOMIC_RELAXED);
+    if (dropped == 0) {
+        return;
+    }
+
+    if (ww_log_ram_claim(WW_LOG_RAM_DROP_WORDS, 1, &pos) == 0) {
+        ww_log_ram_put_marker(pos, dropped);
+    } else {
+        __atomic_fetch_add(&g_ww_log_ram_buffer.drops_pending, dropped, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Decide what to do when a claim failed
+ * @return 0 to retry the claim, -1 to drop the records
+ *
+ * Drop-newest, unless WW_LOG_ASYNC_BLOCK_EN lets the producer wait for
+ * the drain thread (records that can never fit are still dropped).
+ */
+static inline S8 ww_log_ram_full(U32 words)
+{
+#ifdef WW_LOG_ASYNC_BLOCK_EN
+    if (words + WW_LOG_RAM_DROP_WORDS <= WW_LOG_RAM_BUFFER_SIZE) {
+        return ww_log_async_wait();
+    }
+#endif
+    (void)words;
+    return -1;
+}
+
+/**
+ * @brief Reserve 'words' words for 'records' records
+ *
+ * The producer that takes the pending drop count reserves the marker and
+ * its own records in one step; if they do not fit, the count goes back.
+ */
+static inline __attribute__((always_inline))
+S8 ww_log_ram_reserve_records(U32 words, U32 records, U32 *pos)
+{
+    U32 dropped = 0;
+    U32 start;
+
+    if (__atomic_load_n(&g_ww_log_ram_buffer.drops_pending, __ATOMIC_RELAXED) != 0) {
+        dropped = __atomic_exchange_n(&g_ww_log_ram_buffer.drops_pending, 0, __ATOMIC_RELAXED);
+    }
+
+    if (dropped == 0) {
+        while (ww_log_ram_claim(words, records, pos) != 0) {
+            if (ww_log_ram_full(words) != 0) {
+                ww_log_ram_count_drop(records);  /* Buffer full - drop new records */
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    while (ww_log_ram_claim(WW_LOG_RAM_DROP_WORDS + words, records + 1, &start) != 0) {
+        if (ww_log_ram_full(words) != 0) {
+            __atomic_fetch_add(&g_ww_log_ram_buffer.drops_pending, dropped, __ATOMIC_RELAXED);
+            ww_log_ram_count_drop(records);
+            return -1;
+        }
+    }
+
+    ww_log_ram_put_marker(start, dropped);
+    *pos = start + WW_LOG_RAM_DROP_WORDS;
+    return 0;
+}
+
+/* ========== Producer API ========== */
+
+/**
+ * @brief Reserve space for one record
+ */
+S8 ww_log_ram_reserve(U32 words, U32 *pos)
+{
+    return ww_log_ram_reserve_records(words, 1, pos);
+}
+
+/**
+ * @brief Reserve space for a batch of records
+ */
+S8 ww_log_ram_reserve_batch(U32 words, U32 records, U32 *pos)
+{
+    return ww_log_ram_reserve_records(words, records, pos);
+}
+
+/**
+ * @brief Copy a complete record into the ring
+ */
+S8 ww_log_ram_write(const U32 *words, U32 count)
+{
+    U32 pos;
+    U32 i;
+
+    if (ww_log_ram_reserve(count, &pos) != 0) {
+        return -1;
+    }
+
+    for (i = 1; i < count; i++) {
+        WW_LOG_RAM_SLOT(pos + i) = words[i];
+    }
+
+    ww_log_ram_commit(pos, words[0]);
+    return 0;
+}
+
+/* ========== Consumer API ========== */
+
+#ifdef WW_LOG_RAM_OVERWRITE_EN
+/**
+ * @brief Move complete records out of the ring
+ *
+ * Stops at the first record that is reserved but not yet published. Each
+ * record is copied first and then released with a CAS on 'head'; if a
+ * producer evicted it meanwhile the CAS fails and the copy is discarded.
+ * Slots are not cleared (producers zero their header slot on reservation).
+ */
+U32 ww_log_ram_read(U32 *out, U32 max_words)
+{
+    U32 head = __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_ACQUIRE);
+    U32 copied = 0;
+    U32 records = 0;
+
+    for (;;) {
+        U32 tail = __atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_ACQUIRE);
+        U32 header;
+        U32 words;
+        U32 i;
+
+        if (head == tail) {
+            break;  /* Empty */
+        }
+
+        header = __atomic_load_n(&WW_LOG_RAM_SLOT(head), __ATOMIC_ACQUIRE);
+        if (header == 0) {
+            break;  /* Still being written */
+        }
+
+        words = WW_LOG_RAM_REC_WORDS(header);
+        if (copied + words > max_words) {
+            break;
+        }
+
+        out[copied] = header;
+        for (i = 1; i < words; i++) {
+            out[copied + i] = __atomic_load_n(&WW_LOG_RAM_SLOT(head + i), __ATOMIC_RELAXED);
+        }
+
+        /* On failure 'head' is reloaded and the copy is overwritten */
+        if (__atomic_compare_exchange_n(&g_ww_log_ram_buffer.head, &head, head + words, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            head += words;
+            copied += words;
+            records++;
+        }
+    }
+
+    __atomic_fetch_add(&g_ww_log_ram_buffer.records_out, records, __ATOMIC_RELAXED);
+
+    ww_log_ram_flush_drops();
+
+    return copied;
+}
+
+/**
+ * @brief Discard all published records
+ */
+void ww_log_ram_clear(void)
+{
+    U32 head = __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_ACQUIRE);
+    U32 records = 0;
+
+    for (;;) {
+        U32 tail = __atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_ACQUIRE);
+        U32 header;
+
+        if (head == tail) {
+            break;
+        }
+
+        header = __atomic_load_n(&WW_LOG_RAM_SLOT(head), __ATOMIC_ACQUIRE);
+        if (header == 0) {
+            break;
+        }
+
+        if (__atomic_compare_exchange_n(&g_ww_log_ram_buffer.head, &head,
+                                        head + WW_LOG_RAM_REC_WORDS(header), 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            head += WW_LOG_RAM_REC_WORDS(header);
+            records++;
+        }
+    }
+
+    __atomic_fetch_add(&g_ww_log_ram_buffer.records_out, records, __ATOMIC_RELAXED);
+}
+#else
+/**
+ * @brief Move complete records out of the ring
+ *
+ * Stops at the first record that is reserved but not yet published.
+ * Consumed slots are reset to 0 before 'head' is released to producers.
+ */
+U32 ww_log_ram_read(U32 *out, U32 max_words)
+{
+    U32 head = g_ww_log_ram_buffer.head;
+    U32 copied = 0;
+    U32 records = 0;
+
+    for (;;) {
+        U32 header = __atomic_load_n(&WW_LOG_RAM_SLOT(head), __ATOMIC_ACQUIRE);
+        U32 words;
+        U32 i;
+
+        if (header == 0) {
+            break;  /* Empty or still being written */
+        }
+
+        words = WW_LOG_RAM_REC_WORDS(header);
+        if (copied + words > max_words) {
+            break;
+        }
+
+        out[copied++] = header;
+        WW_LOG_RAM_SLOT(head) = 0;
+        for (i = 1; i < words; i++) {
+            out[copied++] = WW_LOG_RAM_SLOT(head + i);
+            WW_LOG_RAM_SLOT(head + i) = 0;
+        }
+        head += words;
+        records++;
+    }
+
+    /* Release the slots to producers */
+    __atomic_fetch_add(&g_ww_log_ram_buffer.records_out, records, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_ww_log_ram_buffer.head, head, __ATOMIC_RELEASE);
+
+    ww_log_ram_flush_drops();
+
+    return copied;
+}
+
+/**
+ * @brief Discard all published records
+ */
+void ww_log_ram_clear(void)
+{
+    U32 head = g_ww_log_ram_buffer.head;
+    U32 records = 0;
+
+    for (;;) {
+        U32 header = __atomic_load_n(&WW_LOG_RAM_SLOT(head), __ATOMIC_ACQUIRE);
+        U32 words;
+        U32 i;
+
+        if (header == 0) {
+            break;
+        }
+
+        words = WW_LOG_RAM_REC_WORDS(header);
+        for (i = 0; i < words; i++) {
+            WW_LOG_RAM_SLOT(head + i) = 0;
+        }
+        head += words;
+        records++;
+    }
+
+    __atomic_fetch_add(&g_ww_log_ram_buffer.records_out, records, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_ww_log_ram_buffer.head, head, __ATOMIC_RELEASE);
+}
+#endif /* WW_LOG_RAM_OVERWRITE_EN */
+
+/**
+ * @brief Copy the published records without consuming them
+ *
+ * A word at position p can only be overwritten after 'head' has moved
+ * past p, so everything from the 'head' read after the copy onwards is
+ * intact. That position is a record boundary, so the valid records are
+ * found by walking the copy from there.
+ */
+U32 ww_log_ram_snapshot(U32 *out, U32 max_words)
+{
+    U32 head = __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_ACQUIRE);
+    U32 tail = __atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_ACQUIRE);
+    U32 count = tail - head;
+    U32 valid;
+    U32 pos;
+    U32 i;
+
+    if (count > max_words) {
+        count = max_words;
+    }
+
+    /* Acquire per word: a published header is read before its parameters */
+    for (i = 0; i < count; i++) {
+        out[i] = __atomic_load_n(&WW_LOG_RAM_SLOT(head + i), __ATOMIC_ACQUIRE);
+    }
+
+    valid = __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_ACQUIRE);
+    if ((U32)(valid - head) >= count) {
+        return 0;  /* Whole copy evicted or consumed meanwhile */
+    }
+
+    /* Keep the complete, published records from 'valid' onwards */
+    pos = valid - head;
+    i = pos;
+    while (i < count && out[i] != 0 && i + WW_LOG_RAM_REC_WORDS(out[i]) <= count) {
+        i += WW_LOG_RAM_REC_WORDS(out[i]);
+    }
+
+    memmove(out, &out[pos], (i - pos) * sizeof(U32));
+    return i - pos;
+}
+
+/**
+ * @brief Get number of words reserved in the ring
+ */
+U32 ww_log_ram_get_count(void)
+{
+    return __atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Read the ring statistics
+ */
+void ww_log_ram_get_stats(WW_LOG_RAM_STATS_T *stats)
+{
+    stats->records = __atomic_load_n(&g_ww_log_ram_buffer.records_in, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&g_ww_log_ram_buffer.dropped, __ATOMIC_RELAXED);
+    stats->bytes = (U64)__atomic_load_n(&g_ww_log_ram_buffer.words_in, __ATOMIC_RELAXED) * 4;
+    stats->high_water = __atomic_load_n(&g_ww_log_ram_buffer.high_water, __ATOMIC_RELAXED);
+    stats->overwritten = __atomic_load_n(&g_ww_log_ram_buffer.overwritten, __ATOMIC_RELAXED);
+    stats->size = WW_LOG_RAM_BUFFER_SIZE;
+}
+
+#endif /* WW_LOG_RAM_BUFFER_EN */
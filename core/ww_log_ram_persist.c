@@ -0,0 +1,207 @@
+/**
+ * @file ww_log_ram_persist.c
+ * @brief File-backed RAM ring: mapping, warm restart recovery and export
+ * @date 2026-10-16
+ *
+ * The ring file holds exactly one WW_LOG_RAM_BUFFER_T. It is mapped
+ * MAP_SHARED, so every store of a producer lands in the page cache and
+ * survives a crash of the process without any syscall on the log path.
+ */
+
+#include "ww_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef WW_LOG_RAM_PERSIST_EN
+
+/* ========== Global Variables ========== */
+
+/**
+ * Ring in use: the boot ring until the file is mapped
+ */
+WW_LOG_RAM_BUFFER_T *g_ww_log_ram_map = &g_ww_log_ram_boot;
+
+static const char *g_persist_path = WW_LOG_RAM_PERSIST_PATH;
+
+/* Previous run, copied out of the file before it is reused */
+static U32 g_prev_words[WW_LOG_RAM_BUFFER_SIZE];
+static U32 g_prev_count = 0;
+
+/* ========== Internal Functions ========== */
+
+/**
+ * @brief Copy the previous run's records out of a ring file
+ * @return 0 if recovered, -1 if the positions are not consistent
+ *
+ * Walks from 'head' and stops at the first slot that is not a published
+ * record header inside [head, tail): records that were still being
+ * written when the process died are cut off there. 'tail' only ever
+ * moves by whole records, so a record running past it means 'head' is
+ * not on a record boundary; nothing is recovered then.
+ */
+static S8 ww_log_ram_recover(const WW_LOG_RAM_BUFFER_T *ring)
+{
+    U32 head = ring->head;
+    U32 tail = ring->tail;
+    U32 pos = head;
+
+    g_prev_count = 0;
+
+    if ((U32)(tail - head) > WW_LOG_RAM_BUFFER_SIZE) {
+        return -1;  /* Positions are corrupt */
+    }
+
+    while (pos != tail) {
+        U32 header = ring->entries[pos & (WW_LOG_RAM_BUFFER_SIZE - 1)];
+        U32 words;
+        U32 i;
+
+        if (header == 0) {
+            break;
+        }
+
+        words = WW_LOG_RAM_REC_WORDS(header);
+        if ((U32)(tail - pos) < words) {
+            g_prev_count = 0;
+            return -1;  /* 'head' is not on a record boundary */
+        }
+
+        for (i = 0; i < words; i++) {
+            g_prev_words[g_prev_count + i] = ring->entries[(pos + i) & (WW_LOG_RAM_BUFFER_SIZE - 1)];
+        }
+        g_prev_count += words;
+        pos += words;
+    }
+
+    return 0;
+}
+
+/* ========== API Implementation ========== */
+
+/**
+ * @brief Select the ring file
+ */
+void ww_log_ram_persist_set_path(const char *path)
+{
+    g_persist_path = path;
+}
+
+/**
+ * @brief Map the ring file, recover the previous run, switch over
+ *
+ * The new ring starts as a copy of the boot ring, so records logged
+ * before ww_log_init() are kept. The mapping stays for the lifetime of
+ * the process.
+ */
+S8 ww_log_ram_persist_open(void)
+{
+    WW_LOG_RAM_BUFFER_T *ring;
+    struct stat st;
+    S8 recovered = 0;
+    int fd;
+
+    if (g_ww_log_ram_map != &g_ww_log_ram_boot) {
+        return 0;  /* Already mapped */
+    }
+
+    fd = open(g_persist_path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (fstat(fd, &st) != 0 ||
+        ((U64)st.st_size != sizeof(WW_LOG_RAM_BUFFER_T) &&
+         ftruncate(fd, sizeof(WW_LOG_RAM_BUFFER_T)) != 0)) {
+        close(fd);
+        return -1;
+    }
+
+    ring = (WW_LOG_RAM_BUFFER_T *)mmap(NULL, sizeof(WW_LOG_RAM_BUFFER_T),
+                                       PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ring == MAP_FAILED) {
+        return -1;
+    }
+
+    /* Warm restart: same layout and consistent positions */
+    g_prev_count = 0;
+    if ((U64)st.st_size == sizeof(WW_LOG_RAM_BUFFER_T) &&
+        ring->magic == WW_LOG_RAM_MAGIC &&
+        ring->version == WW_LOG_RAM_LAYOUT_VERSION &&
+        ring->size == WW_LOG_RAM_BUFFER_SIZE &&
+        ww_log_ram_recover(ring) == 0) {
+        recovered = 1;
+    }
+
+    /* New run: take over the boot ring (init runs before other threads log) */
+    memcpy(ring, &g_ww_log_ram_boot, sizeof(*ring));
+    __atomic_store_n(&g_ww_log_ram_map, ring, __ATOMIC_RELEASE);
+
+    return recovered;
+}
+
+/**
+ * @brief Records recovered from the previous run
+ */
+const U32 *ww_log_ram_prev_get(U32 *words)
+{
+    *words = g_prev_count;
+    return g_prev_words;
+}
+
+/**
+ * @brief Write the previous run's records to a file
+ */
+S8 ww_log_ram_prev_save(const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    S8 ret = 0;
+
+    if (fp == NULL) {
+        return -1;
+    }
+
+#if defined(WW_LOG_MODE_ENCODE)
+    {
+        /* Binary stream, as WW_LOG_ENCODE_OUTPUT_BIN would write it */
+        U32 hdr[3] = {
+            WW_LOG_STREAM_MAGIC,
+            WW_LOG_STREAM_VERSION | ((WW_LOG_STREAM_FLAGS | WW_LOG_STREAM_FLAG_BIN) << 16),
+            WW_LOG_STREAM_BOM,
+        };
+
+        if (fwrite(hdr, sizeof(hdr), 1, fp) != 1 ||
+            fwrite(g_prev_words, sizeof(U32), g_prev_count, fp) != g_prev_count) {
+            ret = -1;
+        }
+    }
+#else
+    {
+        /* Text records: rendered as the drain thread would */
+        char line[WW_LOG_ASYNC_LINE_MAX + 64];
+        U32 idx = 0;
+
+        while (idx < g_prev_count) {
+            U32 len = ww_log_async_render(&g_prev_words[idx], line, sizeof(line));
+
+            if (fwrite(line, 1, len, fp) != len) {
+                ret = -1;
+                break;
+            }
+            idx += WW_LOG_RAM_REC_WORDS(g_prev_words[idx]);
+        }
+    }
+#endif
+
+    if (fclose(fp) != 0) {
+        ret = -1;
+    }
+
+    return ret;
+}
+
+#endif /* WW_LOG_RAM_PERSIST_EN */
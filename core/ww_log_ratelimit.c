@@ -0,0 +1,67 @@
+/**
+ * @file ww_log_ratelimit.c
+ * @brief Per-call-site rate limiting: token bucket refill (slow path)
+ * @date 2026-10-16
+ */
+
+#include "ww_log.h"
+#include <time.h>
+
+#if !defined(WW_LOG_MODE_DISABLED)
+
+/* ========== Internal Functions ========== */
+
+/**
+ * @brief Coarse monotonic time in milliseconds (wraps after 49 days)
+ */
+static U32 ww_log_rl_now_ms(void)
+{
+    struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (U32)((U64)ts.tv_sec * 1000U + (U64)ts.tv_nsec / 1000000U);
+}
+
+/* ========== API Implementation ========== */
+
+/**
+ * @brief Refill an empty bucket
+ *
+ * WW_LOG_RL_BURST tokens accrue per WW_LOG_RL_INTERVAL_MS since the last
+ * refill, capped at WW_LOG_RL_BURST. The caller that wins the CAS on
+ * 'last_ms' refills and takes the first token; without a token the record
+ * is counted as suppressed. The initial burst has no refill time yet
+ * (last_ms 0): the first empty bucket only starts the clock.
+ */
+U8 ww_log_rl_refill(WW_LOG_RL_T *rl)
+{
+    U32 now = ww_log_rl_now_ms() | 1U;  /* Never 0 */
+    U32 last = __atomic_load_n(&rl->last_ms, __ATOMIC_RELAXED);
+    U64 add = 0;
+
+    if (last == 0) {
+        __atomic_compare_exchange_n(&rl->last_ms, &last, now, 0,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    } else {
+        add = (U64)(now - last) * WW_LOG_RL_BURST / WW_LOG_RL_INTERVAL_MS;
+    }
+
+    if (add != 0 &&
+        __atomic_compare_exchange_n(&rl->last_ms, &last, now, 0,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        if (add > WW_LOG_RL_BURST) {
+            add = WW_LOG_RL_BURST;
+        }
+        __atomic_store_n(&rl->tokens, (S32)add - 1, __ATOMIC_RELAXED);
+        return (__atomic_load_n(&rl->suppressed, __ATOMIC_RELAXED) != 0) ? 2 : 1;
+    }
+
+    __atomic_fetch_add(&rl->suppressed, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+#endif /* !WW_LOG_MODE_DISABLED */
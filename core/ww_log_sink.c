@@ -0,0 +1,548 @@
+/**
+ * @file ww_log_sink.c
+ * @brief Built-in output sinks and fan-out
+ * @date 2026-10-16
+ *
+ * Sinks are registered before logging starts, so the fan-out loops read
+ * the sink table without locking. Each sink must tolerate concurrent
+ * writers: fd writes are single syscalls, stdio streams lock internally
+ * and the memory sink reserves its space atomically.
+ *
+ * A sink keeps its slot until it is removed (bit n of the sink mask is
+ * slot n); removing clears the slot and the fan-out skips empty slots,
+ * so no other sink moves.
+ *
+ * Every fan-out call counts itself as a reader of the table in the
+ * current generation, on a counter stripe of its own thread (one cache
+ * line per stripe, so logging threads do not share a written line).
+ * Removing or closing sinks first clears the slots, then moves new
+ * readers to the other generation and waits for the old one to drain
+ * (twice, for a reader that read the generation before an earlier
+ * switch). Readers that start meanwhile count in the new generation and
+ * cannot hold the wait up, and a writer that loaded a slot before it was
+ * cleared registered itself before the load, so a sink is never closed
+ * under a writer.
+ */
+
+#include "ww_log_sink.h"
+#include "ww_log_modules.h"
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX  1024  /* POSIX minimum is 16, Linux uses 1024 */
+#endif
+
+#ifndef WW_LOG_SINK_STRIPES
+#define WW_LOG_SINK_STRIPES  16  /* Reader counter stripes per generation */
+#endif
+
+typedef struct {
+    U32 count;      /* Fan-out calls in flight on this stripe */
+} __attribute__((aligned(64))) WW_LOG_SINK_READERS_T;
+
+/* ========== Global Variables ========== */
+
+static WW_LOG_SINK_T *g_sinks[WW_LOG_SINK_MAX];  /* NULL = free slot */
+static U8 g_sink_slots = 0;     /* Slots in use or freed (fan-out bound) */
+static U8 g_sink_count = 0;     /* Registered sinks */
+static WW_LOG_SINK_READERS_T g_sink_readers[2][WW_LOG_SINK_STRIPES];
+static U32 g_sink_gen = 0;      /* Generation new readers count in (low bit) */
+static U32 g_sink_stripe_next = 0;
+static __thread U8 g_sink_stripe;  /* Stripe of this thread + 1, 0 = none yet */
+static pthread_mutex_t g_sink_lock = PTHREAD_MUTEX_INITIALIZER;  /* add / remove / close */
+
+/* ========== fd Sink ========== */
+
+static S32 ww_log_sink_fd_write(WW_LOG_SINK_T *sink, const void *buf, U32 len)
+{
+    const U8 *p = (const U8 *)buf;
+    U32 left = len;
+
+    while (left > 0) {
+        ssize_t n = write(sink->fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        left -= (U32)n;
+    }
+
+    return (S32)len;
+}
+
+static S32 ww_log_sink_fd_writev(WW_LOG_SINK_T *sink, const struct iovec *iov, U32 count)
+{
+    S32 total = 0;
+
+    while (count > 0) {
+        U32 chunk = (count > IOV_MAX) ? IOV_MAX : count;
+        size_t want = 0;
+        ssize_t n;
+        U32 i;
+
+        for (i = 0; i < chunk; i++) {
+            want += iov[i].iov_len;
+        }
+
+        do {
+            n = writev(sink->fd, iov, (int)chunk);
+        } while (n < 0 && errno == EINTR);
+
+        if (n < 0) {
+            return -1;
+        }
+
+        if ((size_t)n < want) {
+            /* Short write: finish this chunk buffer by buffer */
+            size_t skip = (size_t)n;
+            for (i = 0; i < chunk; i++) {
+                if (skip >= iov[i].iov_len) {
+                    skip -= iov[i].iov_len;
+                    continue;
+                }
+                if (ww_log_sink_fd_write(sink, (const U8 *)iov[i].iov_base + skip,
+                                         (U32)(iov[i].iov_len - skip)) < 0) {
+                    return -1;
+                }
+                skip = 0;
+            }
+        }
+
+        total += (S32)want;
+        iov += chunk;
+        count -= chunk;
+    }
+
+    return total;
+}
+
+static void ww_log_sink_fd_flush(WW_LOG_SINK_T *sink)
+{
+    (void)sink;  /* write() is unbuffered */
+}
+
+static void ww_log_sink_fd_close(WW_LOG_SINK_T *sink)
+{
+    if (sink->owned) {
+        close(sink->fd);
+        sink->owned = 0;
+    }
+}
+
+static const WW_LOG_SINK_OPS_T g_fd_ops = {
+    .write = ww_log_sink_fd_write,
+    .writev = ww_log_sink_fd_writev,
+    .flush = ww_log_sink_fd_flush,
+    .close = ww_log_sink_fd_close,
+};
+
+/**
+ * @brief Initialize a sink on an existing file descriptor
+ */
+void ww_log_sink_fd_init(WW_LOG_SINK_T *sink, S32 fd)
+{
+    memset(sink, 0, sizeof(*sink));
+    sink->ops = &g_fd_ops;
+    sink->fd = fd;
+}
+
+/* ========== File (stdio) Sink ========== */
+
+static S32 ww_log_sink_file_write(WW_LOG_SINK_T *sink, const void *buf, U32 len)
+{
+    return (fwrite(buf, 1, len, sink->fp) == len) ? (S32)len : -1;
+}
+
+static S32 ww_log_sink_file_writev(WW_LOG_SINK_T *sink, const struct iovec *iov, U32 count)
+{
+    S32 total = 0;
+    U32 i;
+
+    /* Hold the stream lock once for the whole batch */
+    flockfile(sink->fp);
+    for (i = 0; i < count; i++) {
+        if (fwrite(iov[i].iov_base, 1, iov[i].iov_len, sink->fp) != iov[i].iov_len) {
+            total = -1;
+            break;
+        }
+        total += (S32)iov[i].iov_len;
+    }
+    funlockfile(sink->fp);
+
+    return total;
+}
+
+static void ww_log_sink_file_flush(WW_LOG_SINK_T *sink)
+{
+    fflush(sink->fp);
+}
+
+static void ww_log_sink_file_close(WW_LOG_SINK_T *sink)
+{
+    if (sink->owned) {
+        fclose(sink->fp);
+        sink->owned = 0;
+    } else {
+        fflush(sink->fp);
+    }
+}
+
+static const WW_LOG_SINK_OPS_T g_file_ops = {
+    .write = ww_log_sink_file_write,
+    .writev = ww_log_sink_file_writev,
+    .flush = ww_log_sink_file_flush,
+    .close = ww_log_sink_file_close,
+};
+
+/**
+ * @brief Initialize a sink on an existing stdio stream
+ */
+void ww_log_sink_file_init(WW_LOG_SINK_T *sink, FILE *fp)
+{
+    memset(sink, 0, sizeof(*sink));
+    sink->ops = &g_file_ops;
+    sink->fp = fp;
+}
+
+/**
+ * @brief Open a file and initialize a file sink that owns it
+ */
+S8 ww_log_sink_file_open(WW_LOG_SINK_T *sink, const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+
+    if (fp == NULL) {
+        return -1;
+    }
+
+    ww_log_sink_file_init(sink, fp);
+    sink->owned = 1;
+    return 0;
+}
+
+/* ========== Memory Sink ========== */
+
+static S32 ww_log_sink_mem_write(WW_LOG_SINK_T *sink, const void *buf, U32 len)
+{
+    U32 pos = __atomic_fetch_add(&sink->mem_used, len, __ATOMIC_RELAXED);
+
+    if (pos >= sink->mem_size) {
+        return 0;  /* Full - drop */
+    }
+    if (len > sink->mem_size - pos) {
+        len = sink->mem_size - pos;
+    }
+
+    memcpy(&sink->mem[pos], buf, len);
+    return (S32)len;
+}
+
+static S32 ww_log_sink_mem_writev(WW_LOG_SINK_T *sink, const struct iovec *iov, U32 count)
+{
+    U32 want = 0;
+    U32 pos;
+    U32 i;
+
+    for (i = 0; i < count; i++) {
+        want += (U32)iov[i].iov_len;
+    }
+
+    /* Reserve the whole batch at once so it stays contiguous */
+    pos = __atomic_fetch_add(&sink->mem_used, want, __ATOMIC_RELAXED);
+    for (i = 0; i < count && pos < sink->mem_size; i++) {
+        U32 len = (U32)iov[i].iov_len;
+
+        if (len > sink->mem_size - pos) {
+            len = sink->mem_size - pos;
+        }
+        memcpy(&sink->mem[pos], iov[i].iov_base, len);
+        pos += len;
+    }
+
+    return (S32)want;
+}
+
+static void ww_log_sink_mem_flush(WW_LOG_SINK_T *sink)
+{
+    (void)sink;
+}
+
+static void ww_log_sink_mem_close(WW_LOG_SINK_T *sink)
+{
+    (void)sink;  /* Buffer belongs to the caller */
+}
+
+static const WW_LOG_SINK_OPS_T g_mem_ops = {
+    .write = ww_log_sink_mem_write,
+    .writev = ww_log_sink_mem_writev,
+    .flush = ww_log_sink_mem_flush,
+    .close = ww_log_sink_mem_close,
+};
+
+/**
+ * @brief Initialize a memory sink
+ *
+ * mem_used keeps counting past mem_size, so (mem_used - mem_size) is the
+ * number of bytes that did not fit.
+ */
+void ww_log_sink_mem_init(WW_LOG_SINK_T *sink, void *buf, U32 size)
+{
+    memset(sink, 0, sizeof(*sink));
+    sink->ops = &g_mem_ops;
+    sink->mem = (U8 *)buf;
+    sink->mem_size = size;
+}
+
+/* ========== Null Sink ========== */
+
+static S32 ww_log_sink_null_write(WW_LOG_SINK_T *sink, const void *buf, U32 len)
+{
+    (void)sink;
+    (void)buf;
+    return (S32)len;
+}
+
+static S32 ww_log_sink_null_writev(WW_LOG_SINK_T *sink, const struct iovec *iov, U32 count)
+{
+    (void)sink;
+    (void)iov;
+    (void)count;
+    return 0;
+}
+
+static void ww_log_sink_null_flush(WW_LOG_SINK_T *sink)
+{
+    (void)sink;
+}
+
+static const WW_LOG_SINK_OPS_T g_null_ops = {
+    .write = ww_log_sink_null_write,
+    .writev = ww_log_sink_null_writev,
+    .flush = ww_log_sink_null_flush,
+    .close = ww_log_sink_null_flush,
+};
+
+/**
+ * @brief Initialize a sink that discards all output
+ */
+void ww_log_sink_null_init(WW_LOG_SINK_T *sink)
+{
+    memset(sink, 0, sizeof(*sink));
+    sink->ops = &g_null_ops;
+}
+
+/* ========== Registration ========== */
+
+/**
+ * @brief Start using the sink table
+ * @param slots Number of slots to visit
+ * @return Reader counter to pass to ww_log_sink_leave()
+ *
+ * Sequentially consistent on both sides (see ww_log_sink_quiesce()):
+ * either a slot is loaded after a removal cleared it, or the removal
+ * sees this reader and waits for it.
+ */
+static inline U32 *ww_log_sink_enter(U8 *slots)
+{
+    U32 stripe = g_sink_stripe;
+    U32 *readers;
+
+    if (stripe == 0) {
+        stripe = __atomic_fetch_add(&g_sink_stripe_next, 1, __ATOMIC_RELAXED) %
+                 WW_LOG_SINK_STRIPES + 1;
+        g_sink_stripe = (U8)stripe;
+    }
+
+    readers = &g_sink_readers[__atomic_load_n(&g_sink_gen, __ATOMIC_RELAXED) & 1]
+                             [stripe - 1].count;
+    __atomic_fetch_add(readers, 1, __ATOMIC_SEQ_CST);
+    *slots = __atomic_load_n(&g_sink_slots, __ATOMIC_ACQUIRE);
+    return readers;
+}
+
+static inline WW_LOG_SINK_T *ww_log_sink_slot(U8 i)
+{
+    return __atomic_load_n(&g_sinks[i], __ATOMIC_SEQ_CST);
+}
+
+static inline void ww_log_sink_leave(U32 *readers)
+{
+    __atomic_fetch_sub(readers, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Wait until no fan-out call that may have seen the old table runs
+ *
+ * Called with g_sink_lock held after slots were cleared; rare (remove,
+ * shutdown), so yielding is good enough. Each pass switches new readers
+ * to the other generation, so only calls already in flight are waited for.
+ */
+static void ww_log_sink_quiesce(void)
+{
+    U32 pass;
+    U32 i;
+
+    for (pass = 0; pass < 2; pass++) {
+        U32 old = __atomic_fetch_add(&g_sink_gen, 1, __ATOMIC_SEQ_CST) & 1;
+
+        for (i = 0; i < WW_LOG_SINK_STRIPES; i++) {
+            while (__atomic_load_n(&g_sink_readers[old][i].count, __ATOMIC_SEQ_CST) != 0) {
+                sched_yield();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Register a sink for output
+ *
+ * Takes the lowest free slot, so a sink added after a removal reuses the
+ * removed sink's slot (and its sink mask bit).
+ */
+S8 ww_log_sink_add(WW_LOG_SINK_T *sink)
+{
+    S8 ret = -1;
+    U8 i;
+
+    pthread_mutex_lock(&g_sink_lock);
+    for (i = 0; i < WW_LOG_SINK_MAX; i++) {
+        if (g_sinks[i] == NULL) {
+            __atomic_store_n(&g_sinks[i], sink, __ATOMIC_RELEASE);
+            if (i >= g_sink_slots) {
+                __atomic_store_n(&g_sink_slots, i + 1, __ATOMIC_RELEASE);
+            }
+            __atomic_store_n(&g_sink_count, g_sink_count + 1, __ATOMIC_RELEASE);
+            ret = 0;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_sink_lock);
+    return ret;
+}
+
+/**
+ * @brief Unregister a sink
+ *
+ * Only its slot is cleared; the other sinks keep their slots and mask bits.
+ */
+void ww_log_sink_remove(WW_LOG_SINK_T *sink)
+{
+    U8 i;
+
+    pthread_mutex_lock(&g_sink_lock);
+    for (i = 0; i < g_sink_slots; i++) {
+        if (g_sinks[i] == sink) {
+            __atomic_store_n(&g_sinks[i], NULL, __ATOMIC_SEQ_CST);
+            __atomic_store_n(&g_sink_count, g_sink_count - 1, __ATOMIC_RELEASE);
+            ww_log_sink_quiesce();  /* Caller may close the sink next */
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_sink_lock);
+}
+
+/**
+ * @brief Get number of registered sinks
+ */
+U8 ww_log_sink_count(void)
+{
+    return __atomic_load_n(&g_sink_count, __ATOMIC_ACQUIRE);
+}
+
+/* ========== Fan-out ========== */
+
+/**
+ * @brief Write one buffer to every selected sink
+ */
+void ww_log_sink_write(const void *buf, U32 len)
+{
+    U8 slots;
+    U32 *readers = ww_log_sink_enter(&slots);
+    U32 mask = ww_log_config_current()->sink_mask;
+    U8 i;
+
+    for (i = 0; i < slots; i++) {
+        WW_LOG_SINK_T *sink = ww_log_sink_slot(i);
+
+        if (sink != NULL && (mask & (1U << i))) {
+            sink->ops->write(sink, buf, len);
+        }
+    }
+    ww_log_sink_leave(readers);
+}
+
+/**
+ * @brief Write a batch of buffers to every selected sink
+ */
+void ww_log_sink_writev(const struct iovec *iov, U32 count)
+{
+    U8 slots;
+    U32 *readers = ww_log_sink_enter(&slots);
+    U32 mask = ww_log_config_current()->sink_mask;
+    U8 i;
+
+    for (i = 0; i < slots; i++) {
+        WW_LOG_SINK_T *sink = ww_log_sink_slot(i);
+
+        if (sink != NULL && (mask & (1U << i))) {
+            sink->ops->writev(sink, iov, count);
+        }
+    }
+    ww_log_sink_leave(readers);
+}
+
+/**
+ * @brief Flush every registered sink
+ */
+void ww_log_sink_flush(void)
+{
+    U8 slots;
+    U32 *readers = ww_log_sink_enter(&slots);
+    U8 i;
+
+    for (i = 0; i < slots; i++) {
+        WW_LOG_SINK_T *sink = ww_log_sink_slot(i);
+
+        if (sink != NULL) {
+            sink->ops->flush(sink);
+        }
+    }
+    ww_log_sink_leave(readers);
+}
+
+/**
+ * @brief Flush, close and unregister every sink
+ *
+ * Writers that start afterwards see no sink and drop their output;
+ * writers already in flight finish before any sink is closed.
+ */
+void ww_log_sink_close_all(void)
+{
+    WW_LOG_SINK_T *sinks[WW_LOG_SINK_MAX];
+    U8 slots;
+    U8 i;
+
+    pthread_mutex_lock(&g_sink_lock);
+    slots = g_sink_slots;
+    for (i = 0; i < slots; i++) {
+        sinks[i] = __atomic_exchange_n(&g_sinks[i], NULL, __ATOMIC_SEQ_CST);
+    }
+    __atomic_store_n(&g_sink_count, 0, __ATOMIC_RELEASE);
+
+    ww_log_sink_quiesce();
+    for (i = 0; i < slots; i++) {
+        if (sinks[i] != NULL) {
+            sinks[i]->ops->flush(sinks[i]);
+            sinks[i]->ops->close(sinks[i]);
+        }
+    }
+    pthread_mutex_unlock(&g_sink_lock);
+}
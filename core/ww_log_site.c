@@ -0,0 +1,54 @@
+/**
+ * @file ww_log_site.c
+ * @brief Per-call-site runtime enable table
+ * @date 2026-10-16
+ */
+
+#include "ww_log.h"
+
+#ifdef WW_LOG_SITE_CTRL_EN
+
+/**
+ * Section bounds (defined by the linker; weak, so a program without any
+ * call site still links)
+ */
+extern WW_LOG_SITE_T __start_ww_log_sites[] __attribute__((weak));
+extern WW_LOG_SITE_T __stop_ww_log_sites[] __attribute__((weak));
+
+/* ========== API Implementation ========== */
+
+/**
+ * @brief Get the call site table
+ */
+WW_LOG_SITE_T *ww_log_site_table(U32 *count)
+{
+    *count = (U32)(__stop_ww_log_sites - __start_ww_log_sites);
+    return __start_ww_log_sites;
+}
+
+/**
+ * @brief Enable or disable the matching call sites
+ *
+ * Each flag is a single byte store, so sites can be switched while other
+ * threads are logging; a call already past its check still completes.
+ */
+U32 ww_log_site_set(const WW_LOG_SITE_QUERY_T *query, U8 enable)
+{
+    WW_LOG_SITE_T *site;
+    U32 matched = 0;
+
+    for (site = __start_ww_log_sites; site < __stop_ww_log_sites; site++) {
+        if ((query->file_id != WW_LOG_SITE_ANY_FILE && site->file_id != query->file_id) ||
+            site->line < query->line_min || site->line > query->line_max ||
+            site->level < query->level_min || site->level > query->level_max) {
+            continue;
+        }
+
+        __atomic_store_n(&site->enabled, enable ? 1 : 0, __ATOMIC_RELAXED);
+        matched++;
+    }
+
+    return matched;
+}
+
+#endif /* WW_LOG_SITE_CTRL_EN */
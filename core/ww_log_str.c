@@ -10,10 +10,42 @@
 #include "ww_log.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 #ifdef WW_LOG_MODE_STR
 
+/**
+ * Ring record header for a rendered text line (async mode)
+ * Uses the DATA_LEN and LEVEL fields of the encode header layout.
+ */
+#define WW_LOG_STR_REC_HDR(words, level) \
+    ((U32)((((U32)(words) & 0x3F) << 2) | ((U32)(level) & 0x3)))
+
+/**
+ * Deferred record flag (WW_LOG_STR_DEFERRED_EN):
+ * [header | DEFER][line][fmt pointer (2 words)][filename pointer (2 words)][arguments]
+ * With PREFIX the line header comes from the call site:
+ * [header | DEFER | PREFIX][prefix length][fmt pointer][prefix pointer][arguments]
+ */
+#define WW_LOG_STR_REC_DEFER   0x100U
+#define WW_LOG_STR_REC_PREFIX  0x200U
+#define WW_LOG_STR_DEFER_HDR_WORDS  6
+
+/**
+ * Line buffers of the sync path: "[LEVEL] filename:line - " and message
+ * are formatted into a thread-local buffer of HEAD_MAX + MSG_MAX bytes;
+ * longer lines into a stack buffer of WW_LOG_STR_LONG_MAX bytes
+ */
+#define WW_LOG_STR_HEAD_MAX  96
+#ifndef WW_LOG_STR_MSG_MAX
+#define WW_LOG_STR_MSG_MAX   512
+#endif
+#ifndef WW_LOG_STR_LONG_MAX
+#define WW_LOG_STR_LONG_MAX  4096
+#endif
+
 /**
  * Level name strings for output
  */
@@ -24,9 +56,747 @@ static const char* level_names[] = {
     "DBG",  /* WW_LOG_LEVEL_DBG = 3 */
 };
 
+/* ========== Line Formatting ========== */
+
+/**
+ * @brief Write the line header "[LEVEL] filename:line - "
+ * @param out Buffer of at least WW_LOG_STR_HEAD_MAX bytes
+ * @return Header length (filename cut to fit WW_LOG_STR_HEAD_MAX)
+ */
+static U32 ww_log_str_head(char *out, const char *filename, U32 line, U8 level)
+{
+    char digits[10];
+    U32 name_len = (U32)strnlen(filename, WW_LOG_STR_HEAD_MAX - 20);
+    U32 len = 0;
+    U32 n = 0;
+
+    out[len++] = '[';
+    memcpy(&out[len], level_names[level], 3);
+    len += 3;
+    out[len++] = ']';
+    out[len++] = ' ';
+    memcpy(&out[len], filename, name_len);
+    len += name_len;
+    out[len++] = ':';
+
+    do {
+        digits[n++] = (char)('0' + line % 10);
+        line /= 10;
+    } while (line != 0);
+    while (n > 0) {
+        out[len++] = digits[--n];
+    }
+
+    memcpy(&out[len], " - ", 3);
+    return len + 3;
+}
+
+/**
+ * @brief Write the line header of a record
+ * @param src Call-site prefix (cached != 0) or filename
+ * @param arg Prefix length (cached != 0) or line number
+ * @param out Buffer of at least WW_LOG_STR_HEAD_MAX bytes
+ * @return Header length
+ *
+ * A call-site prefix is already "[LEVEL] filename:line - " and only copied.
+ */
+static inline U32 ww_log_str_prefix(char *out, const char *src, U32 arg, U8 cached, U8 level)
+{
+    if (cached) {
+        if (arg > WW_LOG_STR_HEAD_MAX) {
+            arg = WW_LOG_STR_HEAD_MAX;
+        }
+        memcpy(out, src, arg);
+        return arg;
+    }
+    return ww_log_str_head(out, src, arg, level);
+}
+
+/* ========== Line Groups ========== */
+
+/**
+ * Lines written as one unit: one sink write (sync) or one ring
+ * reservation (async), so no line of another thread lands in between
+ * and a reader sees none or all of them
+ */
+#ifdef WW_LOG_ASYNC_EN
+#if WW_LOG_STR_LONG_MAX / 4 < WW_LOG_RAM_BUFFER_SIZE - WW_LOG_RAM_DROP_WORDS
+#define WW_LOG_STR_GROUP_WORDS  (WW_LOG_STR_LONG_MAX / 4)
+#else
+#define WW_LOG_STR_GROUP_WORDS  (WW_LOG_RAM_BUFFER_SIZE - WW_LOG_RAM_DROP_WORDS)
+#endif
+#endif
+
+typedef struct {
+#ifdef WW_LOG_ASYNC_EN
+    U32 words[WW_LOG_STR_GROUP_WORDS];  /* Text records, header first */
+    U32 records;
+#else
+    char text[WW_LOG_STR_LONG_MAX];     /* Lines, newline terminated */
+#endif
+    U32 used;   /* Words (async) or bytes (sync) used */
+    U8 level;   /* Most severe level of the lines */
+} WW_LOG_STR_GROUP_T;
+
+/**
+ * @brief Space a line of 'len' bytes takes in a group
+ */
+static inline U32 ww_log_str_group_cost(U32 len)
+{
+#ifdef WW_LOG_ASYNC_EN
+    if (len > WW_LOG_ASYNC_LINE_MAX - 1) {
+        len = WW_LOG_ASYNC_LINE_MAX - 1;
+    }
+    return 1 + (len + 4) / 4;  /* Header + NUL-padded text words */
+#else
+    return len + 1;            /* Newline */
+#endif
+}
+
+static inline U32 ww_log_str_group_room(const WW_LOG_STR_GROUP_T *group)
+{
+#ifdef WW_LOG_ASYNC_EN
+    return WW_LOG_STR_GROUP_WORDS - group->used;
+#else
+    return sizeof(group->text) - group->used;
+#endif
+}
+
+static inline void ww_log_str_group_init(WW_LOG_STR_GROUP_T *group, U8 level)
+{
+#ifdef WW_LOG_ASYNC_EN
+    group->records = 0;
+#endif
+    group->used = 0;
+    group->level = level;
+}
+
+/**
+ * @brief Append a line (without newline) to a group
+ * @return 0 if appended, -1 if the group has no room left for it
+ */
+static S8 ww_log_str_group_add(WW_LOG_STR_GROUP_T *group, const char *text, U32 len, U8 level)
+{
+    U32 cost = ww_log_str_group_cost(len);
+
+    if (cost > ww_log_str_group_room(group)) {
+        return -1;
+    }
+
+#ifdef WW_LOG_ASYNC_EN
+    {
+        U32 *rec = &group->words[group->used];
+
+        if (len > WW_LOG_ASYNC_LINE_MAX - 1) {
+            len = WW_LOG_ASYNC_LINE_MAX - 1;
+        }
+        rec[cost - 1] = 0;  /* NUL-pad the last word */
+        memcpy(&rec[1], text, len);
+        rec[0] = WW_LOG_STR_REC_HDR(cost - 1, level);
+        group->records++;
+    }
+#else
+    memcpy(&group->text[group->used], text, len);
+    group->text[group->used + len] = '\n';
+#endif
+    group->used += cost;
+    if (level < group->level) {
+        group->level = level;
+    }
+    return 0;
+}
+
+/**
+ * @brief Write all lines of a group as one unit
+ *
+ * Async: one ring reservation for all records; every slot but the first
+ * header is filled first and that header publishes the run, like an
+ * encode mode batch. Dropped as a whole if the ring is full.
+ */
+static void ww_log_str_group_write(const WW_LOG_STR_GROUP_T *group)
+{
+    if (group->used == 0) {
+        return;
+    }
+
+#ifdef WW_LOG_ASYNC_EN
+    {
+        U32 pos;
+        U32 i;
+
+        if (ww_log_ram_reserve_batch(group->used, group->records, &pos) != 0) {
+            return;
+        }
+        for (i = 1; i < group->used; i++) {
+            WW_LOG_RAM_SLOT(pos + i) = group->words[i];
+        }
+        ww_log_ram_commit(pos, group->words[0]);
+        ww_log_async_notify(pos + group->used, group->level);
+    }
+#else
+    ww_log_sink_write(group->text, group->used);
+    ww_log_sink_flush();
+#endif
+}
+
+#ifndef WW_LOG_ASYNC_EN
+/* Line buffer of the calling thread */
+static __thread char g_str_line[WW_LOG_STR_HEAD_MAX + WW_LOG_STR_MSG_MAX];
+
+/**
+ * @brief Write a line too long for the thread-local buffer
+ * @param head Header already formatted
+ *
+ * Formatted again into a stack buffer (no heap) and truncated to
+ * WW_LOG_STR_LONG_MAX - 2 bytes; still one sink write per line.
+ */
+static __attribute__((noinline))
+void ww_log_str_write_long(const char *head, U32 head_len, const char *fmt, va_list args)
+{
+    char buf[WW_LOG_STR_LONG_MAX];
+    U32 room = sizeof(buf) - head_len - 1;  /* Keep a byte for the newline */
+    int msg_len;
+
+    memcpy(buf, head, head_len);
+    msg_len = vsnprintf(&buf[head_len], room, fmt, args);
+    if (msg_len < 0) {
+        msg_len = 0;
+    } else if ((U32)msg_len >= room) {
+        msg_len = (int)room - 1;
+    }
+
+    buf[head_len + (U32)msg_len] = '\n';
+    ww_log_sink_write(buf, head_len + (U32)msg_len + 1);
+}
+#endif /* !WW_LOG_ASYNC_EN */
+
+#ifdef WW_LOG_STR_DEFERRED_EN
+
+/* ========== Deferred Formatting ========== */
+
+/**
+ * Argument classes of a conversion specification: what the producer
+ * takes from the va_list and the drain thread passes to snprintf()
+ */
+#define WW_LOG_STR_ARG_NONE     0  /* %% */
+#define WW_LOG_STR_ARG_INT      1  /* int (also char, short, %c): 1 word */
+#define WW_LOG_STR_ARG_LONG     2  /* 64-bit classes below: 2 words */
+#define WW_LOG_STR_ARG_LLONG    3
+#define WW_LOG_STR_ARG_SIZE     4
+#define WW_LOG_STR_ARG_INTMAX   5
+#define WW_LOG_STR_ARG_PTRDIFF  6
+#define WW_LOG_STR_ARG_PTR      7
+#define WW_LOG_STR_ARG_DOUBLE   8
+#define WW_LOG_STR_ARG_STR      9  /* Bytes copied, NUL-terminated, word padded */
+#define WW_LOG_STR_ARG_BAD      10 /* Not deferrable: formatted by the caller */
+
+#define WW_LOG_STR_SPEC_MAX  32  /* Longest conversion specification */
+
+/**
+ * One conversion specification of a format string
+ */
+typedef struct {
+    const char *start;  /* '%' */
+    const char *end;    /* Past the conversion character */
+    S32 prec;           /* Literal precision, -1 if none or '*' */
+    U8 arg;             /* WW_LOG_STR_ARG_xxx */
+    U8 width_star;      /* Width taken from an int argument */
+    U8 prec_star;       /* Precision taken from an int argument */
+} WW_LOG_STR_SPEC_T;
+
+/**
+ * @brief Find the next conversion specification
+ * @param p Current position in the format string
+ * @param spec Output: the specification
+ * @return 0 if one was found, -1 at the end of the string
+ *
+ * Producer and drain thread walk the format string with this function,
+ * so they agree on the argument layout of a record.
+ */
+static S8 ww_log_str_next_spec(const char *p, WW_LOG_STR_SPEC_T *spec)
+{
+    const char *q;
+    U8 len = 0;  /* 'h' = 1, none = 2, 'l' = 3, ll = 4, or the modifier */
+
+    p = strchr(p, '%');
+    if (p == NULL) {
+        return -1;
+    }
+
+    spec->start = p;
+    spec->prec = -1;
+    spec->width_star = 0;
+    spec->prec_star = 0;
+    q = p + 1;
+
+    if (*q == '%') {
+        spec->end = q + 1;
+        spec->arg = WW_LOG_STR_ARG_NONE;
+        return 0;
+    }
+
+    while (*q == '-' || *q == '+' || *q == ' ' || *q == '#' || *q == '0' || *q == '\'') {
+        q++;
+    }
+    if (*q == '*') {
+        spec->width_star = 1;
+        q++;
+    } else {
+        while (*q >= '0' && *q <= '9') {
+            q++;
+        }
+    }
+    if (*q == '.') {
+        q++;
+        if (*q == '*') {
+            spec->prec_star = 1;
+            q++;
+        } else {
+            spec->prec = 0;
+            while (*q >= '0' && *q <= '9') {
+                spec->prec = spec->prec * 10 + (*q - '0');
+                q++;
+            }
+        }
+    }
+
+    switch (*q) {
+    case 'h':
+        len = 1;
+        q += (q[1] == 'h') ? 2 : 1;
+        break;
+    case 'l':
+        len = (q[1] == 'l') ? 4 : 3;
+        q += (q[1] == 'l') ? 2 : 1;
+        break;
+    case 'q':
+        len = 4;
+        q++;
+        break;
+    case 'L': case 'j': case 'z': case 'Z': case 't':
+        len = (U8)*q;
+        q++;
+        break;
+    default:
+        len = 2;
+        break;
+    }
+
+    switch (*q) {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        spec->arg = (len <= 2) ? WW_LOG_STR_ARG_INT :
+                    (len == 3) ? WW_LOG_STR_ARG_LONG :
+                    (len == 4) ? WW_LOG_STR_ARG_LLONG :
+                    (len == 'j') ? WW_LOG_STR_ARG_INTMAX :
+                    (len == 't') ? WW_LOG_STR_ARG_PTRDIFF :
+                    (len == 'L') ? WW_LOG_STR_ARG_BAD : WW_LOG_STR_ARG_SIZE;
+        break;
+    case 'c':
+        spec->arg = (len <= 3) ? WW_LOG_STR_ARG_INT : WW_LOG_STR_ARG_BAD;
+        break;
+    case 's':
+        spec->arg = (len == 2) ? WW_LOG_STR_ARG_STR : WW_LOG_STR_ARG_BAD;
+        break;
+    case 'p':
+        spec->arg = WW_LOG_STR_ARG_PTR;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        spec->arg = (len == 2 || len == 3) ? WW_LOG_STR_ARG_DOUBLE : WW_LOG_STR_ARG_BAD;
+        break;
+    default:
+        /* %n, %m (errno at call time), positional arguments, unknown */
+        spec->arg = WW_LOG_STR_ARG_BAD;
+        break;
+    }
+
+    spec->end = (*q != '\0') ? q + 1 : q;
+    if (spec->end - spec->start >= WW_LOG_STR_SPEC_MAX) {
+        spec->arg = WW_LOG_STR_ARG_BAD;
+    }
+    return 0;
+}
+
+static inline void ww_log_str_put64(U32 *w, U64 v)
+{
+    memcpy(w, &v, sizeof(v));
+}
+
+static inline U64 ww_log_str_get64(const U32 *w)
+{
+    U64 v;
+
+    memcpy(&v, w, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Capture a record for formatting in the drain thread
+ * @return 0 if the record was handed to the ring (or dropped because the
+ *         ring is full), -1 if the format cannot be deferred
+ *
+ * Only the arguments are copied: integers, pointers and doubles as raw
+ * words, %s strings as bytes (the pointer may not outlive the call).
+ * fmt and the filename (or call-site prefix) are kept as pointers and
+ * must stay valid until the record is drained, which string literals do.
+ */
+static S8 ww_log_str_defer(const char *src, U32 arg, U8 cached, U8 level,
+                           const char *fmt, va_list args)
+{
+    U32 rec[1 + 63];
+    U32 words = WW_LOG_STR_DEFER_HDR_WORDS;
+    WW_LOG_STR_SPEC_T spec;
+    const char *p = fmt;
+
+    while (ww_log_str_next_spec(p, &spec) == 0) {
+        S32 prec = spec.prec;
+        U32 need;
+
+        p = spec.end;
+        if (spec.arg == WW_LOG_STR_ARG_NONE) {
+            continue;
+        }
+        if (spec.arg == WW_LOG_STR_ARG_BAD) {
+            return -1;
+        }
+
+        /* '*' ints, then the value (strings: at least the NUL word) */
+        need = spec.width_star + spec.prec_star +
+               ((spec.arg == WW_LOG_STR_ARG_INT || spec.arg == WW_LOG_STR_ARG_STR) ? 1 : 2);
+        if (words + need > 1 + 63) {
+            return -1;
+        }
+
+        if (spec.width_star) {
+            rec[words++] = (U32)va_arg(args, int);
+        }
+        if (spec.prec_star) {
+            prec = va_arg(args, int);
+            rec[words++] = (U32)prec;
+        }
+
+        switch (spec.arg) {
+        case WW_LOG_STR_ARG_INT:
+            rec[words++] = (U32)va_arg(args, int);
+            break;
+        case WW_LOG_STR_ARG_LONG:
+            ww_log_str_put64(&rec[words], (U64)va_arg(args, long));
+            words += 2;
+            break;
+        case WW_LOG_STR_ARG_LLONG:
+            ww_log_str_put64(&rec[words], (U64)va_arg(args, long long));
+            words += 2;
+            break;
+        case WW_LOG_STR_ARG_SIZE:
+            ww_log_str_put64(&rec[words], (U64)va_arg(args, size_t));
+            words += 2;
+            break;
+        case WW_LOG_STR_ARG_INTMAX:
+            ww_log_str_put64(&rec[words], (U64)va_arg(args, intmax_t));
+            words += 2;
+            break;
+        case WW_LOG_STR_ARG_PTRDIFF:
+            ww_log_str_put64(&rec[words], (U64)va_arg(args, ptrdiff_t));
+            words += 2;
+            break;
+        case WW_LOG_STR_ARG_PTR:
+            ww_log_str_put64(&rec[words], (U64)(uintptr_t)va_arg(args, void *));
+            words += 2;
+            break;
+        case WW_LOG_STR_ARG_DOUBLE:
+        {
+            double d = va_arg(args, double);
+
+            memcpy(&rec[words], &d, sizeof(d));
+            words += 2;
+            break;
+        }
+        default:  /* WW_LOG_STR_ARG_STR */
+        {
+            const char *str = va_arg(args, const char *);
+            U32 room = (1 + 63 - words) * 4 - 1;
+            U32 n;
+
+            if (str == NULL) {
+                str = "(null)";
+            }
+            if (prec >= 0 && (U32)prec < room) {
+                room = (U32)prec;
+            }
+            n = (U32)strnlen(str, room);
+
+            /* Copy and NUL-pad the last word */
+            rec[words + n / 4] = 0;
+            memcpy(&rec[words], str, n);
+            words += n / 4 + 1;
+            break;
+        }
+        }
+    }
+
+    rec[0] = WW_LOG_STR_REC_HDR(words - 1, level) | WW_LOG_STR_REC_DEFER |
+             (cached ? WW_LOG_STR_REC_PREFIX : 0);
+    rec[1] = arg;
+    ww_log_str_put64(&rec[2], (U64)(uintptr_t)fmt);
+    ww_log_str_put64(&rec[4], (U64)(uintptr_t)src);
+
+    if (ww_log_ram_write(rec, words) == 0) {
+        ww_log_async_notify(__atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_RELAXED),
+                            level);
+    }
+    return 0;
+}
+
+/**
+ * @brief Append snprintf() output, clamped to the line limit
+ */
+#define WW_LOG_STR_APPEND(out, len, limit, ...) do { \
+    int _n = snprintf(&(out)[len], (limit) + 1 - (len), __VA_ARGS__); \
+    if (_n > 0) { \
+        (len) += ((U32)_n < (limit) - (len)) ? (U32)_n : (limit) - (len); \
+    } \
+} while (0)
+
+/**
+ * @brief Format a deferred record (drain thread)
+ * @param limit Longest line without the newline (out holds limit + 1 bytes)
+ * @return Length of the line
+ */
+static U32 ww_log_str_render_deferred(const U32 *rec, char *out, U32 limit)
+{
+    const U32 *arg = &rec[WW_LOG_STR_DEFER_HDR_WORDS];
+    const char *fmt = (const char *)(uintptr_t)ww_log_str_get64(&rec[2]);
+    const char *src = (const char *)(uintptr_t)ww_log_str_get64(&rec[4]);
+    WW_LOG_STR_SPEC_T spec;
+    const char *p = fmt;
+    char head[WW_LOG_STR_HEAD_MAX];
+    U32 len;
+
+    len = ww_log_str_prefix(head, src, rec[1], (rec[0] & WW_LOG_STR_REC_PREFIX) != 0,
+                            (U8)(rec[0] & 0x3));
+    if (len > limit) {
+        len = limit;
+    }
+    memcpy(out, head, len);
+
+    while (ww_log_str_next_spec(p, &spec) == 0) {
+        char conv[WW_LOG_STR_SPEC_MAX + 24];
+        const char *c;
+        U32 n = (U32)(spec.start - p);
+        U32 k = 0;
+        S32 prec = 0;
+
+        /* Literal text up to the specification */
+        if (n > limit - len) {
+            n = limit - len;
+        }
+        memcpy(&out[len], p, n);
+        len += n;
+        p = spec.end;
+
+        if (spec.arg == WW_LOG_STR_ARG_NONE) {
+            WW_LOG_STR_APPEND(out, len, limit, "%%");
+            continue;
+        }
+
+        /* Specification with the '*' values filled in */
+        for (c = spec.start; c < spec.end; c++) {
+            if (*c != '*') {
+                conv[k++] = *c;
+            } else if (c[-1] != '.') {
+                k += (U32)snprintf(&conv[k], sizeof(conv) - k, "%d", (int)*arg++);
+            } else {
+                prec = (S32)*arg++;
+                if (prec >= 0) {
+                    k += (U32)snprintf(&conv[k], sizeof(conv) - k, "%d", (int)prec);
+                } else {
+                    k--;  /* Negative precision: as if omitted, drop the '.' */
+                }
+            }
+        }
+        conv[k] = '\0';
+
+        switch (spec.arg) {
+        case WW_LOG_STR_ARG_INT:
+            WW_LOG_STR_APPEND(out, len, limit, conv, (int)*arg);
+            arg++;
+            break;
+        case WW_LOG_STR_ARG_LONG:
+            WW_LOG_STR_APPEND(out, len, limit, conv, (long)ww_log_str_get64(arg));
+            arg += 2;
+            break;
+        case WW_LOG_STR_ARG_LLONG:
+            WW_LOG_STR_APPEND(out, len, limit, conv, (long long)ww_log_str_get64(arg));
+            arg += 2;
+            break;
+        case WW_LOG_STR_ARG_SIZE:
+            WW_LOG_STR_APPEND(out, len, limit, conv, (size_t)ww_log_str_get64(arg));
+            arg += 2;
+            break;
+        case WW_LOG_STR_ARG_INTMAX:
+            WW_LOG_STR_APPEND(out, len, limit, conv, (intmax_t)ww_log_str_get64(arg));
+            arg += 2;
+            break;
+        case WW_LOG_STR_ARG_PTRDIFF:
+            WW_LOG_STR_APPEND(out, len, limit, conv, (ptrdiff_t)ww_log_str_get64(arg));
+            arg += 2;
+            break;
+        case WW_LOG_STR_ARG_PTR:
+            WW_LOG_STR_APPEND(out, len, limit, conv, (void *)(uintptr_t)ww_log_str_get64(arg));
+            arg += 2;
+            break;
+        case WW_LOG_STR_ARG_DOUBLE:
+        {
+            double d;
+
+            memcpy(&d, arg, sizeof(d));
+            WW_LOG_STR_APPEND(out, len, limit, conv, d);
+            arg += 2;
+            break;
+        }
+        default:  /* WW_LOG_STR_ARG_STR */
+        {
+            const char *str = (const char *)arg;
+
+            WW_LOG_STR_APPEND(out, len, limit, conv, str);
+            arg += strlen(str) / 4 + 1;
+            break;
+        }
+        }
+    }
+
+    /* Literal text after the last specification */
+    {
+        U32 n = (U32)strlen(p);
+
+        if (n > limit - len) {
+            n = limit - len;
+        }
+        memcpy(&out[len], p, n);
+        len += n;
+    }
+
+    return len;
+}
+
+#endif /* WW_LOG_STR_DEFERRED_EN */
+
+#ifdef WW_LOG_ASYNC_EN
+/**
+ * @brief Render header + message as one text record
+ * @param rec Record buffer of 1 + WW_LOG_ASYNC_LINE_MAX / 4 words
+ * @return Record words (header included)
+ *
+ * The line is truncated to WW_LOG_ASYNC_LINE_MAX - 1 bytes and NUL-padded
+ * to a whole word; DATA_LEN counts the text words.
+ */
+static U32 ww_log_str_text_rec(U32 *rec, const char *src, U32 arg, U8 cached, U8 level,
+                               const char *fmt, va_list args)
+{
+    char *text = (char *)&rec[1];
+    int len = (int)ww_log_str_prefix(text, src, arg, cached, level);
+    int msg_len = vsnprintf(&text[len], WW_LOG_ASYNC_LINE_MAX - len, fmt, args);
+    U32 words;
+
+    if (msg_len > 0) {
+        len += msg_len;
+    }
+    if (len > WW_LOG_ASYNC_LINE_MAX - 1) {
+        len = WW_LOG_ASYNC_LINE_MAX - 1;
+    }
+
+    words = ((U32)len + 4) / 4;
+    memset(&text[len], 0, words * 4 - (U32)len);
+    rec[0] = WW_LOG_STR_REC_HDR(words, level);
+    return 1 + words;
+}
+#endif /* WW_LOG_ASYNC_EN */
+
+/**
+ * @brief Format and write one line (filtering already done)
+ * @param src Call-site prefix (cached != 0) or filename
+ * @param arg Prefix length (cached != 0) or line number
+ *
+ * Output format: [LEVEL] filename:line - message
+ * Example: [INF] brom_boot.c:42 - Boot sequence started
+ *
+ * Sync mode: header and message are formatted into a thread-local line
+ * buffer in one pass and handed to each sink with one write, so lines of
+ * different threads never interleave. Lines that do not fit are formatted
+ * into a stack buffer instead (truncated to WW_LOG_STR_LONG_MAX - 2 bytes).
+ * Async mode: the line is rendered into a stack buffer and copied into the
+ * RAM ring as one text record; the drain thread writes it out.
+ * Deferred mode (WW_LOG_STR_DEFERRED_EN): only the arguments are copied
+ * into the ring and the drain thread formats the line; formats that
+ * cannot be deferred take the async path.
+ */
+static void ww_log_str_vout(const char *src, U32 arg, U8 cached, U8 level,
+                            const char *fmt, va_list args)
+{
+    va_list ap;
+#ifdef WW_LOG_ASYNC_EN
+    U32 words;
+#endif
+
+#ifdef WW_LOG_STR_DEFERRED_EN
+    {
+        S8 ret;
+
+        va_copy(ap, args);
+        ret = ww_log_str_defer(src, arg, cached, level, fmt, ap);
+        va_end(ap);
+        if (ret == 0) {
+            return;
+        }
+    }
+#endif
+
+#ifdef WW_LOG_ASYNC_EN
+    {
+        U32 rec[1 + WW_LOG_ASYNC_LINE_MAX / 4];
+
+        va_copy(ap, args);
+        words = ww_log_str_text_rec(rec, src, arg, cached, level, fmt, ap);
+        va_end(ap);
+
+        if (ww_log_ram_write(rec, words) == 0) {
+            ww_log_async_notify(__atomic_load_n(&g_ww_log_ram_buffer.tail, __ATOMIC_RELAXED),
+                                level);
+        }
+        return;
+    }
+#endif /* WW_LOG_ASYNC_EN */
+
+#ifndef WW_LOG_ASYNC_EN
+    {
+        char *buf = g_str_line;
+        U32 head_len = ww_log_str_prefix(buf, src, arg, cached, level);
+        U32 room = sizeof(g_str_line) - head_len - 1;  /* Keep a byte for the newline */
+        int msg_len;
+
+        /* Header and message in one buffer, one write per sink */
+        va_copy(ap, args);
+        msg_len = vsnprintf(&buf[head_len], room, fmt, ap);
+        va_end(ap);
+        if (msg_len < 0) {
+            msg_len = 0;
+        }
+
+        if ((U32)msg_len < room) {
+            buf[head_len + (U32)msg_len] = '\n';
+            ww_log_sink_write(buf, head_len + (U32)msg_len + 1);
+        } else {
+            ww_log_str_write_long(buf, head_len, fmt, args);
+        }
+
+        /* Flush output for immediate visibility */
+        ww_log_sink_flush();
+    }
+#endif /* !WW_LOG_ASYNC_EN */
+}
+
 /**
  * @brief Core string mode output function (with internal filtering)
- * @param module_id Module ID for filtering (0-31)
+ * @param file_id File ID for filtering (CURRENT_FILE_ID)
  * @param filename Source filename (without path)
  * @param line Line number
  * @param level Log level (0-3)
@@ -34,48 +804,264 @@ static const char* level_names[] = {
  * @param ... Variable arguments
  *
  * This function performs all checks internally:
- * 1. Module enable check (via g_ww_log_module_mask)
- * 2. Level threshold check (via g_ww_log_level_threshold)
- *
- * Output format: [LEVEL] filename:line - message
- * Example: [INF] brom_boot.c:42 - Boot sequence started
+ * 1. Module enable check
+ * 2. Module / file level threshold check
+ * (both combined in the level table of the configuration snapshot)
  */
-void ww_log_str_output(U8 module_id, const char *filename, U32 line, U8 level,
+void ww_log_str_output(U16 file_id, const char *filename, U32 line, U8 level,
                        const char *fmt, ...)
 {
     va_list args;
 
-    /* Check module enable (dynamic switch) */
-    if ((g_ww_log_module_mask & (1U << module_id)) == 0) {
+    /* Check module enable and level threshold (dynamic switches) */
+    if (!ww_log_level_enabled(file_id, level)) {
         return;
     }
 
-    /* Check level threshold (dynamic switch) */
-    if (level > g_ww_log_level_threshold) {
+    /* Validate level for array access */
+    if (level > WW_LOG_LEVEL_DBG) {
+        level = WW_LOG_LEVEL_DBG;
+    }
+
+    va_start(args, fmt);
+    ww_log_str_vout(filename, line, 0, level, fmt, args);
+    va_end(args);
+}
+
+/**
+ * @brief String mode output with the call-site prefix (LOG_XXX macros)
+ *
+ * The header "[LEVEL] filename:line - " was built by the preprocessor
+ * (_WW_LOG_STR_PREFIX) and is copied, not formatted.
+ */
+void ww_log_str_output_prefix(U16 file_id, const char *prefix, U32 prefix_len, U8 level,
+                              const char *fmt, ...)
+{
+    va_list args;
+
+    if (!ww_log_level_enabled(file_id, level)) {
         return;
     }
 
-    /* Validate level for array access */
     if (level > WW_LOG_LEVEL_DBG) {
         level = WW_LOG_LEVEL_DBG;
     }
 
-    /* Print header: [LEVEL] filename:line - */
-    printf("[%s] %s:%u - ",
-           level_names[level],
-           filename,
-           line);
+    va_start(args, fmt);
+    ww_log_str_vout(prefix, prefix_len, 1, level, fmt, args);
+    va_end(args);
+}
+
+/**
+ * @brief Hex dump of a byte buffer
+ *
+ * The filter is checked once and all lines are written as one line group
+ * (one sink write, or one ring reservation in async mode), so the dump
+ * never interleaves with other threads' output. A dump that does not fit
+ * the group (WW_LOG_STR_LONG_MAX bytes) ends with a line giving the
+ * number of bytes left out.
+ */
+void ww_log_str_hex(U16 file_id, const char *filename, U32 line, U8 level,
+                    const void *data, U32 len)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    const U8 *bytes = (const U8 *)data;
+    WW_LOG_STR_GROUP_T group;
+    char text[WW_LOG_STR_HEAD_MAX + 64];
+    U32 head_len;
+    U32 offset;
+    U32 i;
+
+    if (!ww_log_level_enabled(file_id, level)) {
+        return;
+    }
+
+    if (level > WW_LOG_LEVEL_DBG) {
+        level = WW_LOG_LEVEL_DBG;
+    }
+    if (bytes == NULL) {
+        len = 0;
+    }
+
+    ww_log_str_group_init(&group, level);
+    head_len = ww_log_str_head(text, filename, line, level);
+
+    ww_log_str_group_add(&group, text,
+                         head_len + (U32)snprintf(&text[head_len], 64, "hex %u bytes", len),
+                         level);
+
+    for (offset = 0; offset < len; offset += 16) {
+        U32 n = (len - offset < 16) ? len - offset : 16;
+        U32 text_len = head_len + (U32)snprintf(&text[head_len], 16, "%04X: ", offset);
+
+        for (i = 0; i < n; i++) {
+            text[text_len++] = hex[bytes[offset + i] >> 4];
+            text[text_len++] = hex[bytes[offset + i] & 0xF];
+            text[text_len++] = ' ';
+        }
+        text_len--;
+
+        /* Keep room for the closing line */
+        if (ww_log_str_group_room(&group) <
+            ww_log_str_group_cost(text_len) + ww_log_str_group_cost(head_len + 32)) {
+            text_len = head_len + (U32)snprintf(&text[head_len], 64, "... %u bytes not shown",
+                                                len - offset);
+            ww_log_str_group_add(&group, text, text_len, level);
+            break;
+        }
+        ww_log_str_group_add(&group, text, text_len, level);
+    }
+
+    ww_log_str_group_write(&group);
+}
+
+/**
+ * @brief Report the records suppressed by a call site's rate limit
+ */
+void ww_log_str_suppressed(U16 file_id, const char *filename, U32 line, U8 level,
+                           U32 *suppressed)
+{
+    U32 count = __atomic_exchange_n(suppressed, 0, __ATOMIC_RELAXED);
+
+    if (count != 0) {
+        ww_log_str_output(file_id, filename, line, level,
+                          "%u records suppressed (rate limit)", count);
+    }
+}
+
+#ifdef WW_LOG_ASYNC_EN
+/* ========== Batched Records ========== */
+
+#if WW_LOG_BATCH_WORDS + WW_LOG_BATCH_DROP_WORDS > WW_LOG_RAM_BUFFER_SIZE - WW_LOG_RAM_DROP_WORDS
+#error "WW_LOG_BATCH_WORDS does not fit in the RAM ring (WW_LOG_RAM_BUFFER_SIZE)"
+#endif
+
+/**
+ * @brief Start a batch and check the filter for it
+ */
+void ww_log_str_batch_begin(WW_LOG_BATCH_T *batch, U16 file_id, U8 level)
+{
+    batch->used = 0;
+    batch->records = 0;
+    batch->dropped = 0;
+    batch->level = (level > WW_LOG_LEVEL_DBG) ? WW_LOG_LEVEL_DBG : level;
+    batch->enabled = ww_log_level_enabled(file_id, level) ? 1 : 0;
+}
+
+/**
+ * @brief Render a line into a batch
+ */
+void ww_log_str_batch_add(WW_LOG_BATCH_T *batch, const char *filename, U32 line,
+                          const char *fmt, ...)
+{
+    U32 rec[1 + WW_LOG_ASYNC_LINE_MAX / 4];
+    U32 words;
+    va_list args;
 
-    /* Print formatted message */
     va_start(args, fmt);
-    vprintf(fmt, args);
+    words = ww_log_str_text_rec(rec, filename, line, 0, batch->level, fmt, args);
     va_end(args);
 
-    /* Print newline */
-    printf("\n");
+    if (batch->used + words > WW_LOG_BATCH_WORDS) {
+        batch->dropped++;
+        return;
+    }
+    memcpy(&batch->words[batch->used], rec, words * 4);
+    batch->used += words;
+    batch->records++;
+}
+
+/**
+ * @brief Write all lines of a batch with one ring reservation
+ *
+ * Every slot but the first header is filled before that header is
+ * published, as in encode mode; dropped as a whole if the ring is full.
+ */
+void ww_log_str_batch_commit(WW_LOG_BATCH_T *batch)
+{
+    U32 *words = batch->words;
+    U32 used = batch->used;
+    U32 records = batch->records;
+    U32 pos;
+    U32 i;
+
+    /* Lines left out: a warning line closes the batch */
+    if (batch->dropped != 0) {
+        char *text = (char *)&words[used + 1];
+        int len = snprintf(text, (WW_LOG_BATCH_DROP_WORDS - 1) * 4,
+                           "[WRN] ww_log: %u batch lines not shown", batch->dropped);
+        U32 n;
+
+        if (len < 0) {
+            len = 0;
+        } else if (len > (WW_LOG_BATCH_DROP_WORDS - 1) * 4 - 1) {
+            len = (WW_LOG_BATCH_DROP_WORDS - 1) * 4 - 1;
+        }
+        n = ((U32)len + 4) / 4;
+        memset(&text[len], 0, n * 4 - (U32)len);
+        words[used] = WW_LOG_STR_REC_HDR(n, WW_LOG_LEVEL_WRN);
+        used += 1 + n;
+        records++;
+    }
+
+    if (records == 0) {
+        return;
+    }
+
+    if (ww_log_ram_reserve_batch(used, records, &pos) != 0) {
+        return;  /* Buffer full - drop the whole batch */
+    }
+    for (i = 1; i < used; i++) {
+        WW_LOG_RAM_SLOT(pos + i) = words[i];
+    }
+    ww_log_ram_commit(pos, words[0]);
+    ww_log_async_notify(pos + used, (batch->dropped != 0 && batch->level > WW_LOG_LEVEL_WRN) ?
+                                    WW_LOG_LEVEL_WRN : batch->level);
+}
+
+/**
+ * @brief Render one text record as an output line (drain thread)
+ *
+ * Drop markers from the ring are rendered as a warning line, deferred
+ * records are formatted here (truncated to WW_LOG_ASYNC_LINE_MAX - 1
+ * bytes like a line rendered by the caller).
+ */
+U32 ww_log_async_render(const U32 *rec, char *out, U32 size)
+{
+    U32 max = (WW_LOG_RAM_REC_WORDS(rec[0]) - 1) * 4;
+    U32 len;
+
+    if (rec[0] == WW_LOG_RAM_DROP_HDR) {
+        int n = snprintf(out, size, "[WRN] ww_log: %u records dropped (ring full)\n",
+                         rec[WW_LOG_RAM_DROP_WORDS - 1]);
+
+        return (n < 0) ? 0 : ((U32)n < size) ? (U32)n : size - 1;
+    }
+
+#ifdef WW_LOG_STR_DEFERRED_EN
+    if ((rec[0] & WW_LOG_STR_REC_DEFER) != 0) {
+        if (size < 2) {
+            return 0;
+        }
+        len = ww_log_str_render_deferred(rec, out, (size - 1 < WW_LOG_ASYNC_LINE_MAX - 1) ?
+                                                   size - 1 : WW_LOG_ASYNC_LINE_MAX - 1);
+        out[len++] = '\n';
+        return len;
+    }
+#endif
+
+    len = (U32)strnlen((const char *)&rec[1], max);
+
+    if (len + 1 > size) {
+        len = (size > 0) ? size - 1 : 0;
+    }
+    memcpy(out, &rec[1], len);
+    if (len < size) {
+        out[len++] = '\n';
+    }
 
-    /* Flush output for immediate visibility */
-    fflush(stdout);
+    return len;
 }
+#endif /* WW_LOG_ASYNC_EN */
 
 #endif /* WW_LOG_MODE_STR */
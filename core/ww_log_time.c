@@ -0,0 +1,201 @@
+/**
+ * @file ww_log_time.c
+ * @brief Clock sources, calibration and sync epochs for record timestamps
+ * @date 2026-10-16
+ */
+
+#include "ww_log.h"
+#include <time.h>
+#include <pthread.h>
+
+#ifdef WW_LOG_ENCODE_TIMESTAMP_EN
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/* ========== Clock Sources ========== */
+
+static U64 ww_log_clock_read_posix(clockid_t id)
+{
+    struct timespec ts;
+
+    clock_gettime(id, &ts);
+    return (U64)ts.tv_sec * 1000000000ULL + (U64)ts.tv_nsec;
+}
+
+static U64 ww_log_clock_monotonic_read(void)
+{
+    return ww_log_clock_read_posix(CLOCK_MONOTONIC);
+}
+
+static U64 ww_log_clock_monotonic_coarse_read(void)
+{
+#ifdef CLOCK_MONOTONIC_COARSE
+    return ww_log_clock_read_posix(CLOCK_MONOTONIC_COARSE);
+#else
+    return ww_log_clock_read_posix(CLOCK_MONOTONIC);
+#endif
+}
+
+static U64 ww_log_clock_tsc_read(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    U64 ticks;
+
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return ww_log_clock_read_posix(CLOCK_MONOTONIC);
+#endif
+}
+
+const WW_LOG_CLOCK_T g_ww_log_clock_monotonic = {
+    .id = WW_LOG_CLOCK_ID_MONOTONIC,
+    .name = "monotonic",
+    .read = ww_log_clock_monotonic_read,
+    .hz = 1000000000ULL,
+};
+
+const WW_LOG_CLOCK_T g_ww_log_clock_monotonic_coarse = {
+    .id = WW_LOG_CLOCK_ID_MONOTONIC_COARSE,
+    .name = "monotonic_coarse",
+    .read = ww_log_clock_monotonic_coarse_read,
+    .hz = 1000000000ULL,
+};
+
+const WW_LOG_CLOCK_T g_ww_log_clock_tsc = {
+    .id = WW_LOG_CLOCK_ID_TSC,
+    .name = "tsc",
+    .read = ww_log_clock_tsc_read,
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    .hz = 0,  /* Measured by ww_log_time_start() */
+#else
+    .hz = 1000000000ULL,
+#endif
+};
+
+/* ========== Global Variables ========== */
+
+#ifndef WW_LOG_TS_CLOCK
+#define WW_LOG_TS_CLOCK  g_ww_log_clock_monotonic
+#endif
+
+const WW_LOG_CLOCK_T *g_ww_log_clock = &WW_LOG_TS_CLOCK;
+
+U64 g_ww_log_ts_sync = 0;
+
+static pthread_mutex_t g_resync_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ========== Internal Functions ========== */
+
+/**
+ * @brief Measure the tick rate against CLOCK_MONOTONIC over ~10 ms
+ */
+static U64 ww_log_time_calibrate(void)
+{
+    struct timespec pause = { 0, 10 * 1000000L };
+    U64 mono0 = ww_log_clock_read_posix(CLOCK_MONOTONIC);
+    U64 tick0 = g_ww_log_clock->read();
+    U64 mono1;
+    U64 tick1;
+
+    nanosleep(&pause, NULL);
+
+    tick1 = g_ww_log_clock->read();
+    mono1 = ww_log_clock_read_posix(CLOCK_MONOTONIC);
+
+    if (mono1 == mono0) {
+        return 1000000000ULL;
+    }
+    return (U64)((double)(tick1 - tick0) * 1e9 / (double)(mono1 - mono0));
+}
+
+/**
+ * @brief Write a sync record for (base << 2) | epoch
+ * @return 0 if written, -1 if dropped (ring full)
+ */
+static S8 ww_log_time_write_sync(U64 sync)
+{
+    U64 base = sync >> 2;
+    U32 words[3] = {
+        (U32)(sync & WW_LOG_TS_EPOCH_MASK),
+        (U32)base,
+        (U32)(base >> 32),
+    };
+
+    return ww_log_encode_control(WW_LOG_CTRL_SYNC, words, 3);
+}
+
+/* ========== API Implementation ========== */
+
+/**
+ * @brief Select the clock source
+ */
+void ww_log_time_set_clock(const WW_LOG_CLOCK_T *clock)
+{
+    g_ww_log_clock = clock;
+}
+
+/**
+ * @brief Calibration record + first sync record
+ *
+ * Calibration payload: [clock ID][hz lo][hz hi][ref ticks lo][ref ticks hi]
+ *                      [ref CLOCK_REALTIME ns lo][ref CLOCK_REALTIME ns hi]
+ */
+void ww_log_time_start(void)
+{
+    U64 hz = (g_ww_log_clock->hz != 0) ? g_ww_log_clock->hz : ww_log_time_calibrate();
+    U64 ref_ticks = g_ww_log_clock->read();
+    U64 ref_ns = ww_log_clock_read_posix(CLOCK_REALTIME);
+    U32 calib[7] = {
+        g_ww_log_clock->id,
+        (U32)hz, (U32)(hz >> 32),
+        (U32)ref_ticks, (U32)(ref_ticks >> 32),
+        (U32)ref_ns, (U32)(ref_ns >> 32),
+    };
+
+    ww_log_encode_control(WW_LOG_CTRL_CALIB, calib, 7);
+
+    /* No earlier epoch to fall back to: without the record the decoder
+     * shows epoch 0 items as raw deltas */
+    pthread_mutex_lock(&g_resync_lock);
+    g_ww_log_ts_sync = ref_ticks << 2;
+    (void)ww_log_time_write_sync(g_ww_log_ts_sync);
+    pthread_mutex_unlock(&g_resync_lock);
+}
+
+/**
+ * @brief Start the next sync epoch
+ *
+ * Only the first producer to find 'seen' exhausted writes the sync
+ * record; the others wait for it and use the new epoch. The sync record
+ * is reserved before the new epoch is published, so every record of the
+ * new epoch comes after it in the stream.
+ *
+ * If the sync record is dropped (ring full) the old epoch stays current:
+ * publishing the new one would leave the decoder without its base. The
+ * caller gets 'seen' back and the next record retries.
+ */
+U64 ww_log_time_resync(U64 seen)
+{
+    U64 sync;
+
+    pthread_mutex_lock(&g_resync_lock);
+    sync = __atomic_load_n(&g_ww_log_ts_sync, __ATOMIC_ACQUIRE);
+    if (sync == seen) {
+        U64 next = (g_ww_log_clock->read() << 2) | ((seen + 1) & WW_LOG_TS_EPOCH_MASK);
+
+        if (ww_log_time_write_sync(next) == 0) {
+            __atomic_store_n(&g_ww_log_ts_sync, next, __ATOMIC_RELEASE);
+            sync = next;
+        }
+    }
+    pthread_mutex_unlock(&g_resync_lock);
+
+    return sync;
+}
+
+#endif /* WW_LOG_ENCODE_TIMESTAMP_EN */
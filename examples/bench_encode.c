@@ -0,0 +1,153 @@
+/**
+ * @file bench_encode.c
+ * @brief Encode mode call overhead benchmark
+ * @date 2026-10-16
+ *
+ * Built and run by `make bench` (encode mode, RAM ring, no I/O):
+ * - cycles per call for 0-4 parameters, LOG_XXX() (fixed-arity entry
+ *   points) against a direct call of the variadic ww_log_encode_output()
+ * - LOG_XXX() behind the inline pre-filter (what -DWW_LOG_PREFILTER_EN
+ *   expands to), for choosing that option per build
+ * - both for records that are written to the ring and records rejected
+ *   by the runtime level threshold
+ *
+ * The bench_sites_* functions hold the same five call sites in each
+ * style; `make bench` prints their sizes for the bytes-per-site figure.
+ * Build without WW_LOG_PREFILTER_EN, or the fixed column is pre-filtered
+ * as well.
+ */
+
+#include "ww_log.h"
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT  "cycles"
+static inline uint64_t bench_now(void)
+{
+    return __rdtsc();
+}
+#else
+#define BENCH_UNIT  "ns"
+static inline uint64_t bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#define BENCH_BATCH    1024  /* Calls between ring clears (fits the ring) */
+#define BENCH_BATCHES  512
+
+/**
+ * The variadic call exactly as LOG_INF() expanded before the fixed-arity
+ * entry points existed
+ */
+#define VLOG_INF(n, ...) \
+    ww_log_encode_output(CURRENT_MODULE_ID, CURRENT_FILE_ID, __LINE__, \
+                         WW_LOG_LEVEL_INF, n, ##__VA_ARGS__)
+
+/**
+ * LOG_INF() as expanded with -DWW_LOG_PREFILTER_EN
+ */
+#define PLOG_INF(fmt, ...) do { \
+    if (_WW_LOG_LEVEL_PASS(CURRENT_FILE_ID, WW_LOG_LEVEL_INF)) { \
+        LOG_INF(fmt, ##__VA_ARGS__); \
+    } \
+} while (0)
+
+/* ========== Call Sites (code size) ========== */
+
+__attribute__((noinline)) void bench_sites_fixed(U32 a, U32 b, U32 c, U32 d)
+{
+    LOG_INF("none");
+    LOG_INF("a=%u", a);
+    LOG_INF("a=%u b=%u", a, b);
+    LOG_INF("a=%u b=%u c=%u", a, b, c);
+    LOG_INF("a=%u b=%u c=%u d=%u", a, b, c, d);
+}
+
+__attribute__((noinline)) void bench_sites_variadic(U32 a, U32 b, U32 c, U32 d)
+{
+    VLOG_INF(0);
+    VLOG_INF(1, a);
+    VLOG_INF(2, a, b);
+    VLOG_INF(3, a, b, c);
+    VLOG_INF(4, a, b, c, d);
+}
+
+__attribute__((noinline)) void bench_sites_prefilter(U32 a, U32 b, U32 c, U32 d)
+{
+    PLOG_INF("none");
+    PLOG_INF("a=%u", a);
+    PLOG_INF("a=%u b=%u", a, b);
+    PLOG_INF("a=%u b=%u c=%u", a, b, c);
+    PLOG_INF("a=%u b=%u c=%u d=%u", a, b, c, d);
+}
+
+/* ========== Timing ========== */
+
+/**
+ * Run stmt BENCH_BATCH * BENCH_BATCHES times, clearing the ring between
+ * batches outside the timed region; evaluates to cost per call
+ */
+#define BENCH_RUN(stmt) ({ \
+    uint64_t total = 0; \
+    U32 batch, i; \
+    for (batch = 0; batch < BENCH_BATCHES; batch++) { \
+        uint64_t t0 = bench_now(); \
+        for (i = 0; i < BENCH_BATCH; i++) { \
+            stmt; \
+        } \
+        total += bench_now() - t0; \
+        ww_log_ram_clear(); \
+    } \
+    (double)total / ((double)BENCH_BATCH * BENCH_BATCHES); \
+})
+
+static void bench_table(const char *title)
+{
+    double fixed[5];
+    double variadic[5];
+    double prefilter[5];
+    U32 n;
+
+    fixed[0] = BENCH_RUN(LOG_INF("none"));
+    fixed[1] = BENCH_RUN(LOG_INF("%u", i));
+    fixed[2] = BENCH_RUN(LOG_INF("%u %u", i, batch));
+    fixed[3] = BENCH_RUN(LOG_INF("%u %u %u", i, batch, i));
+    fixed[4] = BENCH_RUN(LOG_INF("%u %u %u %u", i, batch, i, batch));
+
+    variadic[0] = BENCH_RUN(VLOG_INF(0));
+    variadic[1] = BENCH_RUN(VLOG_INF(1, i));
+    variadic[2] = BENCH_RUN(VLOG_INF(2, i, batch));
+    variadic[3] = BENCH_RUN(VLOG_INF(3, i, batch, i));
+    variadic[4] = BENCH_RUN(VLOG_INF(4, i, batch, i, batch));
+
+    prefilter[0] = BENCH_RUN(PLOG_INF("none"));
+    prefilter[1] = BENCH_RUN(PLOG_INF("%u", i));
+    prefilter[2] = BENCH_RUN(PLOG_INF("%u %u", i, batch));
+    prefilter[3] = BENCH_RUN(PLOG_INF("%u %u %u", i, batch, i));
+    prefilter[4] = BENCH_RUN(PLOG_INF("%u %u %u %u", i, batch, i, batch));
+
+    printf("%s (%s/call)\n", title, BENCH_UNIT);
+    printf("  params   fixed  variadic  prefilter\n");
+    for (n = 0; n < 5; n++) {
+        printf("  %6u %7.1f %9.1f %10.1f\n", n, fixed[n], variadic[n], prefilter[n]);
+    }
+}
+
+int main(void)
+{
+    ww_log_init();
+
+    bench_table("Recorded to RAM ring");
+
+    ww_log_set_level_threshold(WW_LOG_LEVEL_WRN);
+    bench_table("Rejected by level threshold");
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file bench_str.c
+ * @brief String mode output throughput benchmark
+ * @date 2026-10-16
+ *
+ * Built and run by `make bench-str` (string mode, sync output):
+ * - lines per second of LOG_INF() against the previous output path
+ *   (header and message in two stack buffers, one writev of three
+ *   buffers per line), copied below as bench_str_writev()
+ * - 1 and BENCH_THREADS threads, on a null sink (formatting only), an fd
+ *   sink on /dev/null (one syscall per line) and a stdio sink on
+ *   /dev/null (stream lock, buffered)
+ * - interleaving check: BENCH_THREADS threads log into a memory sink,
+ *   then every line is parsed back; a line mixed with another thread's
+ *   output fails the check
+ *
+ * Exits with 1 if the interleaving check failed.
+ */
+
+#include "ww_log.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#if !defined(WW_LOG_MODE_STR) || defined(WW_LOG_MODE_ENCODE) || defined(WW_LOG_ASYNC_EN)
+#error "bench_str.c measures the sync string mode output path"
+#endif
+
+#define BENCH_THREADS  4
+#define BENCH_LINES    200000  /* Per thread */
+#define BENCH_CHECK_LINES  5000
+
+#define BENCH_MEM_SIZE  (BENCH_THREADS * BENCH_CHECK_LINES * 96)
+
+static U8 g_use_writev;
+
+/* ========== Previous Output Path ========== */
+
+/**
+ * ww_log_str_output() sync path before the thread-local line buffer
+ */
+static void bench_str_writev(U16 file_id, const char *filename, U32 line, U8 level,
+                             const char *fmt, ...)
+{
+    static const char *names[] = { "ERR", "WRN", "INF", "DBG" };
+    char head[96];
+    char msg[512];
+    struct iovec iov[3];
+    va_list args;
+    int head_len;
+    int msg_len;
+
+    if (!ww_log_level_enabled(file_id, level)) {
+        return;
+    }
+
+    head_len = snprintf(head, sizeof(head), "[%s] %s:%u - ", names[level], filename, line);
+    if (head_len < 0) {
+        head_len = 0;
+    } else if (head_len >= (int)sizeof(head)) {
+        head_len = sizeof(head) - 1;
+    }
+
+    va_start(args, fmt);
+    msg_len = vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    if (msg_len < 0) {
+        msg_len = 0;
+    } else if (msg_len >= (int)sizeof(msg)) {
+        msg_len = sizeof(msg) - 1;
+    }
+
+    iov[0].iov_base = head;
+    iov[0].iov_len = (size_t)head_len;
+    iov[1].iov_base = msg;
+    iov[1].iov_len = (size_t)msg_len;
+    iov[2].iov_base = (void *)"\n";
+    iov[2].iov_len = 1;
+    ww_log_sink_writev(iov, 3);
+    ww_log_sink_flush();
+}
+
+/* ========== Threads ========== */
+
+static void *bench_thread(void *arg)
+{
+    U32 id = (U32)(uintptr_t)arg;
+    U32 lines = (id & 0x100U) ? BENCH_CHECK_LINES : BENCH_LINES;
+    U32 i;
+
+    id &= 0xFF;
+    for (i = 0; i < lines; i++) {
+        if (g_use_writev) {
+            bench_str_writev(CURRENT_FILE_ID, __NOTDIR_FILE__, __LINE__, WW_LOG_LEVEL_INF,
+                             "thread %u line %u: status %s, %d bytes", id, i, "ok", 512);
+        } else {
+            LOG_INF("thread %u line %u: status %s, %d bytes", id, i, "ok", 512);
+        }
+    }
+    return NULL;
+}
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Run 'threads' threads and return million lines per second
+ */
+static double bench_run(U32 threads, U32 flags)
+{
+    pthread_t tid[BENCH_THREADS];
+    double t0 = bench_now();
+    U32 i;
+
+    for (i = 0; i < threads; i++) {
+        pthread_create(&tid[i], NULL, bench_thread, (void *)(uintptr_t)(i | flags));
+    }
+    for (i = 0; i < threads; i++) {
+        pthread_join(tid[i], NULL);
+    }
+
+    return (double)threads * BENCH_LINES / (bench_now() - t0) / 1e6;
+}
+
+/**
+ * @brief One table row: both paths on 1 and BENCH_THREADS threads
+ */
+static void bench_row(const char *name, WW_LOG_SINK_T *sink)
+{
+    double r[4];
+
+    ww_log_sink_add(sink);
+    g_use_writev = 1;
+    r[0] = bench_run(1, 0);
+    r[1] = bench_run(BENCH_THREADS, 0);
+    g_use_writev = 0;
+    r[2] = bench_run(1, 0);
+    r[3] = bench_run(BENCH_THREADS, 0);
+    ww_log_sink_remove(sink);
+
+    printf("  %-6s %9.2f %9.2f %9.2f %9.2f\n", name, r[0], r[1], r[2], r[3]);
+}
+
+/* ========== Interleaving Check ========== */
+
+/**
+ * @brief Parse the memory sink back line by line
+ * @return Number of malformed or missing lines
+ */
+static U32 bench_check(const char *mem, U32 size)
+{
+    static U32 next[BENCH_THREADS];
+    const char *p = mem;
+    const char *end = mem + size;
+    U32 errors = 0;
+    U32 i;
+
+    while (p < end) {
+        const char *nl = memchr(p, '\n', (size_t)(end - p));
+        U32 id;
+        U32 n;
+        int used = 0;
+
+        if (nl == NULL ||
+            sscanf(p, "[INF] bench_str.c:%*u - thread %u line %u: status ok, 512 bytes%n",
+                   &id, &n, &used) != 2 ||
+            p + used != nl || id >= BENCH_THREADS || n != next[id]) {
+            errors++;
+            if (nl == NULL) {
+                break;
+            }
+        } else {
+            next[id]++;
+        }
+        p = nl + 1;
+    }
+
+    for (i = 0; i < BENCH_THREADS; i++) {
+        if (next[i] != BENCH_CHECK_LINES) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+/* ========== Main ========== */
+
+int main(void)
+{
+    static WW_LOG_SINK_T null_sink, fd_sink, file_sink, mem_sink;
+    pthread_t tid[BENCH_THREADS];
+    char *mem = malloc(BENCH_MEM_SIZE);
+    FILE *fp = fopen("/dev/null", "w");
+    S32 fd = open("/dev/null", O_WRONLY);
+    U32 errors;
+    U32 i;
+
+    if (mem == NULL || fp == NULL || fd < 0) {
+        printf("bench_str: setup failed\n");
+        return 1;
+    }
+
+    ww_log_sink_null_init(&null_sink);
+    ww_log_sink_fd_init(&fd_sink, fd);
+    ww_log_sink_file_init(&file_sink, fp);
+    ww_log_sink_mem_init(&mem_sink, mem, BENCH_MEM_SIZE);
+
+    /* Install a sink first so ww_log_init() does not add stdout */
+    ww_log_sink_add(&null_sink);
+    ww_log_init();
+    ww_log_sink_remove(&null_sink);
+
+    printf("String mode output throughput (million lines/s)\n");
+    printf("  sink     writev  writev x%u   LOG_INF  LOG_INF x%u\n",
+           BENCH_THREADS, BENCH_THREADS);
+    bench_row("null", &null_sink);
+    bench_row("fd", &fd_sink);
+    bench_row("stdio", &file_sink);
+
+    ww_log_sink_add(&mem_sink);
+    for (i = 0; i < BENCH_THREADS; i++) {
+        pthread_create(&tid[i], NULL, bench_thread, (void *)(uintptr_t)(i | 0x100U));
+    }
+    for (i = 0; i < BENCH_THREADS; i++) {
+        pthread_join(tid[i], NULL);
+    }
+    ww_log_sink_remove(&mem_sink);
+
+    errors = bench_check(mem, (mem_sink.mem_used < BENCH_MEM_SIZE) ?
+                              mem_sink.mem_used : BENCH_MEM_SIZE);
+    printf("Interleaving check: %u threads x %u lines, %u bad lines\n",
+           BENCH_THREADS, BENCH_CHECK_LINES, errors);
+
+    fclose(fp);
+    close(fd);
+    free(mem);
+    return (errors == 0) ? 0 : 1;
+}
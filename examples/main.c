@@ -13,6 +13,16 @@
 #include "ww_log.h"
 #include <stdio.h>
 
+/**
+ * Stream for the test banners: a binary encode stream owns stdout (the
+ * default sink), so the banners go to stderr with WW_LOG_ENCODE_OUTPUT_BIN
+ */
+#if defined(WW_LOG_MODE_ENCODE) && defined(WW_LOG_ENCODE_OUTPUT_BIN)
+#define DEMO_OUT  stderr
+#else
+#define DEMO_OUT  stdout
+#endif
+
 /* External function declarations from all modules */
 
 /* DEMO module */
@@ -47,10 +57,10 @@ extern void drv_i2c_write(int device_addr, int data);
  */
 static void print_test_header(const char *title)
 {
-    printf("\n");
-    printf("========================================\n");
-    printf("  %s\n", title);
-    printf("========================================\n");
+    fprintf(DEMO_OUT, "\n");
+    fprintf(DEMO_OUT, "========================================\n");
+    fprintf(DEMO_OUT, "  %s\n", title);
+    fprintf(DEMO_OUT, "========================================\n");
 }
 
 /**
@@ -58,7 +68,9 @@ static void print_test_header(const char *title)
  */
 static void print_separator(void)
 {
-    printf("\n");
+    /* Keep async log output in order with the test banners */
+    ww_log_flush();
+    fprintf(DEMO_OUT, "\n");
 }
 
 /**
@@ -66,161 +78,226 @@ static void print_separator(void)
  */
 int main(void)
 {
-    printf("\n");
-    printf("=======================================\n");
-    printf("  Log System Test Program (New Design)\n");
-    printf("=======================================\n");
+    fprintf(DEMO_OUT, "\n");
+    fprintf(DEMO_OUT, "=======================================\n");
+    fprintf(DEMO_OUT, "  Log System Test Program (New Design)\n");
+    fprintf(DEMO_OUT, "=======================================\n");
 
     /* Show current mode */
 #if defined(WW_LOG_MODE_DISABLED)
-    printf("  Mode: DISABLED\n");
+    fprintf(DEMO_OUT, "  Mode: DISABLED\n");
 #elif defined(WW_LOG_MODE_STR)
-    printf("  Mode: STRING MODE\n");
+    fprintf(DEMO_OUT, "  Mode: STRING MODE\n");
 #elif defined(WW_LOG_MODE_ENCODE)
-    printf("  Mode: ENCODE MODE\n");
+    fprintf(DEMO_OUT, "  Mode: ENCODE MODE\n");
 #ifdef WW_LOG_ENCODE_RAM_BUFFER_EN
-    printf("  RAM Buffer: ENABLED (%d entries)\n", WW_LOG_RAM_BUFFER_SIZE);
+    fprintf(DEMO_OUT, "  RAM Buffer: ENABLED (%d entries)\n", WW_LOG_RAM_BUFFER_SIZE);
 #endif
 #else
-    printf("  Mode: DEFAULT (STRING)\n");
+    fprintf(DEMO_OUT, "  Mode: DEFAULT (STRING)\n");
+#endif
+#ifdef WW_LOG_ASYNC_EN
+    fprintf(DEMO_OUT, "  Output: ASYNC (drain thread)\n");
 #endif
 
-    printf("  Log Level Threshold: %d (runtime configurable)\n", ww_log_get_level_threshold());
-    printf("=======================================\n\n");
+    fprintf(DEMO_OUT, "  Log Level Threshold: %d (runtime configurable)\n", ww_log_get_level_threshold());
+    fprintf(DEMO_OUT, "=======================================\n\n");
 
     /* Initialize log system */
     ww_log_init();
+#ifdef WW_LOG_RAM_PERSIST_EN
+    if (ww_log_ram_prev_save("ww_log_prev.bin") == 0) {
+        fprintf(DEMO_OUT, "Previous run saved to ww_log_prev.bin\n");
+    }
+#endif
     print_separator();
 
     /* ===== DEMO Module Tests ===== */
     print_test_header("DEMO Module Tests");
-    printf("Testing demo_init() with custom file offset (LOG_ID=33)...\n");
+    fprintf(DEMO_OUT, "Testing demo_init() with custom file offset (LOG_ID=33)...\n");
     demo_init();
     print_separator();
 
-    printf("Testing demo_process() with custom file offset (LOG_ID=34)...\n");
+    fprintf(DEMO_OUT, "Testing demo_process() with custom file offset (LOG_ID=34)...\n");
     demo_process(42);
     print_separator();
 
     /* ===== BROM Module Tests ===== */
     print_test_header("BROM Module Tests");
-    printf("Testing brom_boot_execute() with custom file offset (LOG_ID=161)...\n");
+    fprintf(DEMO_OUT, "Testing brom_boot_execute() with custom file offset (LOG_ID=161)...\n");
     brom_boot_execute();
     print_separator();
 
-    printf("Testing brom_boot_check() with custom file offset (LOG_ID=161)...\n");
+    fprintf(DEMO_OUT, "Testing brom_boot_check() with custom file offset (LOG_ID=161)...\n");
     brom_boot_check();
     print_separator();
 
     /* ===== TEST Module Tests ===== */
     print_test_header("TEST Module Tests");
-    printf("Testing test_unit_run() with custom file offset (LOG_ID=65)...\n");
+    fprintf(DEMO_OUT, "Testing test_unit_run() with custom file offset (LOG_ID=65)...\n");
     test_unit_run();
     print_separator();
 
-    printf("Testing test_integration_run() with custom file offset (LOG_ID=66)...\n");
+    fprintf(DEMO_OUT, "Testing test_integration_run() with custom file offset (LOG_ID=66)...\n");
     test_integration_run();
     print_separator();
 
-    printf("Testing test_stress_run() with custom file offset (LOG_ID=67)...\n");
+    fprintf(DEMO_OUT, "Testing test_stress_run() with custom file offset (LOG_ID=67)...\n");
     test_stress_run();
     print_separator();
 
     /* ===== APP Module Tests ===== */
     print_test_header("APP Module Tests");
-    printf("Testing app_main() with custom file offset (LOG_ID=97)...\n");
+    fprintf(DEMO_OUT, "Testing app_main() with custom file offset (LOG_ID=97)...\n");
     app_main();
     print_separator();
 
-    printf("Testing app_config_load() with custom file offset (LOG_ID=98)...\n");
+    fprintf(DEMO_OUT, "Testing app_config_load() with custom file offset (LOG_ID=98)...\n");
     app_config_load();
     print_separator();
 
-    printf("Testing app_config_save() with custom file offset (LOG_ID=98)...\n");
+    fprintf(DEMO_OUT, "Testing app_config_save() with custom file offset (LOG_ID=98)...\n");
     app_config_save();
     print_separator();
 
     /* ===== DRIVERS Module Tests ===== */
     print_test_header("DRIVERS Module Tests");
-    printf("Testing drv_uart_init() with custom file offset (LOG_ID=129)...\n");
+    fprintf(DEMO_OUT, "Testing drv_uart_init() with custom file offset (LOG_ID=129)...\n");
     drv_uart_init();
     print_separator();
 
-    printf("Testing drv_uart_send()...\n");
+    fprintf(DEMO_OUT, "Testing drv_uart_send()...\n");
     drv_uart_send(128);
     print_separator();
 
-    printf("Testing drv_spi_init() with custom file offset (LOG_ID=130)...\n");
+    fprintf(DEMO_OUT, "Testing drv_spi_init() with custom file offset (LOG_ID=130)...\n");
     drv_spi_init();
     print_separator();
 
-    printf("Testing drv_spi_transfer()...\n");
+    fprintf(DEMO_OUT, "Testing drv_spi_transfer()...\n");
     drv_spi_transfer(64, 64);
     print_separator();
 
-    printf("Testing drv_i2c_init() with custom file offset (LOG_ID=131)...\n");
+    fprintf(DEMO_OUT, "Testing drv_i2c_init() with custom file offset (LOG_ID=131)...\n");
     drv_i2c_init();
     print_separator();
 
-    printf("Testing drv_i2c_read()...\n");
+    fprintf(DEMO_OUT, "Testing drv_i2c_read()...\n");
     drv_i2c_read(0x50, 0x10);
     print_separator();
 
-    printf("Testing drv_i2c_write()...\n");
+    fprintf(DEMO_OUT, "Testing drv_i2c_write()...\n");
+    drv_i2c_write(0x50, 0xAB);
+    print_separator();
+
+#ifdef WW_LOG_SITE_CTRL_EN
+    {
+        WW_LOG_SITE_QUERY_T query = WW_LOG_SITE_QUERY_ALL;
+        U32 count;
+
+        ww_log_site_table(&count);
+        query.file_id = FILE_ID_SRC_DRIVERS_DRV_I2C_C;
+        query.level_min = WW_LOG_LEVEL_DBG;
+        fprintf(DEMO_OUT, "Disabling DBG call sites of drv_i2c.c (%u of %u sites)...\n",
+                ww_log_site_set(&query, 0), count);
+        drv_i2c_write(0x50, 0xAB);
+        ww_log_site_set(&query, 1);
+        print_separator();
+    }
+#endif
+
+#if !defined(WW_LOG_MODE_DISABLED)
+    /* ===== Per-Module Level Tests ===== */
+    print_test_header("Per-Module Level Tests");
+    fprintf(DEMO_OUT, "Global WRN, DRIVERS at DBG: TEST module quiet, drivers verbose...\n");
+    ww_log_set_level_threshold(WW_LOG_LEVEL_WRN);
+    ww_log_set_module_level(WW_LOG_MODULE_DRIVERS, WW_LOG_LEVEL_DBG);
+    test_unit_run();
+    drv_spi_transfer(64, 64);
+    print_separator();
+
+    fprintf(DEMO_OUT, "drv_spi.c overridden to WRN, rest of DRIVERS stays at DBG...\n");
+    ww_log_set_file_level(FILE_ID_SRC_DRIVERS_DRV_SPI_C, WW_LOG_LEVEL_WRN);
+    drv_spi_transfer(64, 64);
     drv_i2c_write(0x50, 0xAB);
+    ww_log_clear_file_level(FILE_ID_SRC_DRIVERS_DRV_SPI_C);
+    ww_log_set_level_threshold(WW_LOG_LEVEL_DBG);
     print_separator();
+#endif
 
     /* ===== Direct Logging Tests ===== */
     print_test_header("Direct Logging Tests");
-    printf("Testing LOG macros with DEFAULT module (module_id=0)...\n");
+    fprintf(DEMO_OUT, "Testing LOG macros with DEFAULT module (module_id=0)...\n");
     LOG_ERR("This is an error message");
     LOG_WRN("This is a warning message");
     LOG_INF("This is an info message");
     LOG_DBG("This is a debug message");
     print_separator();
 
-    printf("Testing LOG macros with parameters (DEFAULT module)...\n");
+    fprintf(DEMO_OUT, "Testing LOG macros with parameters (DEFAULT module)...\n");
     LOG_INF("Integer value: %d", 12345);
     LOG_INF("Multiple values: %d, %d, %d", 10, 20, 30);
     print_separator();
 
-    printf("Testing LOG macros with different module IDs...\n");
+    fprintf(DEMO_OUT, "Testing LOG macros with different module IDs...\n");
     LOG_ERR("TEST module error message");
     LOG_INF("APP module log: value=%d", 999);
     print_separator();
 
+    /* ===== Batched Records ===== */
+    print_test_header("Batched Records");
+    fprintf(DEMO_OUT, "Testing LOG_BATCH_BEGIN/ADD/COMMIT (records written together)...\n");
+    {
+        LOG_BATCH_BEGIN(cfg, WW_LOG_LEVEL_INF);
+        LOG_BATCH_ADD(cfg, "Batch record 1 of 3");
+        LOG_BATCH_ADD(cfg, "Batch record 2 of 3: %d, %d", 10, 20);
+        LOG_BATCH_ADD(cfg, "Batch record 3 of 3: %s", "done");
+        LOG_BATCH_COMMIT(cfg);
+    }
+    print_separator();
+
 #if defined(WW_LOG_MODE_ENCODE) && defined(WW_LOG_ENCODE_RAM_BUFFER_EN)
     /* ===== RAM Buffer Dump ===== */
     print_test_header("RAM Buffer Dump");
-    printf("Dumping all encoded logs from RAM buffer...\n");
+    fprintf(DEMO_OUT, "Dumping all encoded logs from RAM buffer...\n");
     ww_log_ram_dump();
     print_separator();
 
-    printf("Clearing RAM buffer...\n");
+    {
+        WW_LOG_RAM_STATS_T stats;
+
+        ww_log_ram_get_stats(&stats);
+        fprintf(DEMO_OUT, "Ring stats: %u records, %u dropped, %u overwritten, %llu bytes, "
+                "high water %u/%u words\n",
+                stats.records, stats.dropped, stats.overwritten,
+                (unsigned long long)stats.bytes, stats.high_water, stats.size);
+    }
+
+    fprintf(DEMO_OUT, "Clearing RAM buffer...\n");
     ww_log_ram_clear();
-    printf("Buffer cleared. Current count: %u\n", ww_log_ram_get_count());
+    fprintf(DEMO_OUT, "Buffer cleared. Current count: %u\n", ww_log_ram_get_count());
     print_separator();
 #endif
 
     /* ===== Test Complete ===== */
-    printf("\n");
-    printf("=======================================\n");
-    printf("  All Tests Completed\n");
-    printf("=======================================\n");
-    printf("\nTest Summary:\n");
-    printf("- All 5 modules tested: DEMO, BROM, TEST, APP, DRIVERS\n");
-    printf("- Module-level IDs (64 files per module):\n");
-    printf("  DEFAULT(0-63), DEMO(64-127), TEST(128-191)\n");
-    printf("  APP(192-255), DRV(256-319), BROM(320-383)\n");
-    printf("- File-level differentiation: Enabled in all modules\n");
-    printf("- Optional module parameter: Defaults to [DEFA] when not specified\n");
-    printf("- Both string and encode modes supported\n");
-    printf("\nNext steps:\n");
-    printf("- Compile with 'make MODE=str' for string mode\n");
-    printf("- Compile with 'make MODE=encode' for encode mode\n");
-    printf("- Check code size with 'size bin/log_test_{str,encode}'\n");
-    printf("- Decode binary logs with 'tools/log_decoder.py'\n");
-    printf("=======================================\n\n");
+    fprintf(DEMO_OUT, "\n");
+    fprintf(DEMO_OUT, "=======================================\n");
+    fprintf(DEMO_OUT, "  All Tests Completed\n");
+    fprintf(DEMO_OUT, "=======================================\n");
+    fprintf(DEMO_OUT, "\nTest Summary:\n");
+    fprintf(DEMO_OUT, "- All 5 modules tested: DEMO, BROM, TEST, APP, DRIVERS\n");
+    fprintf(DEMO_OUT, "- Module-level IDs (64 files per module):\n");
+    fprintf(DEMO_OUT, "  DEFAULT(0-63), DEMO(64-127), TEST(128-191)\n");
+    fprintf(DEMO_OUT, "  APP(192-255), DRV(256-319), BROM(320-383)\n");
+    fprintf(DEMO_OUT, "- File-level differentiation: Enabled in all modules\n");
+    fprintf(DEMO_OUT, "- Optional module parameter: Defaults to [DEFA] when not specified\n");
+    fprintf(DEMO_OUT, "- Both string and encode modes supported\n");
+    fprintf(DEMO_OUT, "\nNext steps:\n");
+    fprintf(DEMO_OUT, "- Compile with 'make MODE=str' for string mode\n");
+    fprintf(DEMO_OUT, "- Compile with 'make MODE=encode' for encode mode\n");
+    fprintf(DEMO_OUT, "- Check code size with 'size bin/log_test_{str,encode}'\n");
+    fprintf(DEMO_OUT, "- Decode binary logs with 'tools/log_decoder.py'\n");
+    fprintf(DEMO_OUT, "=======================================\n\n");
 
     return 0;
 }
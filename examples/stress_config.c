@@ -0,0 +1,150 @@
+/**
+ * @file stress_config.c
+ * @brief Runtime configuration stress test
+ * @date 2026-10-16
+ *
+ * Built and run by `make stress` (encode mode, output to null sinks):
+ * - producer threads log through LOG_INF() and check every snapshot they
+ *   copy with ww_log_config_read(): modules A and B are never both on or
+ *   both off, the level table and the sink selection always match the
+ *   module mask
+ * - a flipper thread swaps A/B and the sink selection in one transaction
+ * - updater threads enable and disable their own module bits with the
+ *   read-modify-write APIs and check that no update of another thread
+ *   has cleared them (lost update)
+ *
+ * Exits with 1 if any check failed.
+ */
+
+#include "ww_log.h"
+#include <pthread.h>
+#include <stdio.h>
+
+#define STRESS_PRODUCERS  4
+#define STRESS_UPDATERS   2
+#define STRESS_ROUNDS     20000
+
+#define STRESS_MODULE_A   8  /* This file (CURRENT_MODULE_ID) */
+#define STRESS_MODULE_B   9
+#define STRESS_BITS       8  /* Module bits per updater, from 16 */
+
+static volatile U8 g_stop;
+static U32 g_errors;
+static U64 g_checked;
+
+/* ========== Threads ========== */
+
+/**
+ * @brief Check one snapshot for a half-applied update
+ */
+static U8 stress_check(const WW_LOG_CONFIG_T *cfg)
+{
+    U32 a = WW_LOG_MODULE_BIT(cfg->module_mask, STRESS_MODULE_A);
+    U32 b = WW_LOG_MODULE_BIT(cfg->module_mask, STRESS_MODULE_B);
+
+    return (a != b) &&
+           ((cfg->level_table[STRESS_MODULE_A * WW_LOG_FILES_PER_MODULE] != 0) == a) &&
+           ((cfg->level_table[STRESS_MODULE_B * WW_LOG_FILES_PER_MODULE] != 0) == b) &&
+           (cfg->sink_mask == (a ? 0x1U : 0x2U));
+}
+
+static void *stress_producer(void *arg)
+{
+    static __thread WW_LOG_CONFIG_T cfg;
+    U32 id = (U32)(uintptr_t)arg;
+    U32 n = 0;
+
+    while (!__atomic_load_n(&g_stop, __ATOMIC_RELAXED)) {
+        ww_log_config_read(&cfg);
+        if (!stress_check(&cfg)) {
+            __atomic_fetch_add(&g_errors, 1, __ATOMIC_RELAXED);
+        }
+        LOG_INF("producer %u record %u", id, n);
+        n++;
+    }
+    __atomic_fetch_add(&g_checked, n, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static void *stress_flipper(void *arg)
+{
+    U32 i;
+
+    (void)arg;
+    for (i = 0; i < STRESS_ROUNDS; i++) {
+        WW_LOG_CONFIG_T *cfg = ww_log_config_begin();
+
+        cfg->module_mask[0] ^= (1U << STRESS_MODULE_A) | (1U << STRESS_MODULE_B);
+        cfg->sink_mask = WW_LOG_MODULE_BIT(cfg->module_mask, STRESS_MODULE_A) ? 0x1U : 0x2U;
+        ww_log_config_commit(cfg);
+    }
+    return NULL;
+}
+
+static void *stress_updater(void *arg)
+{
+    U8 first = 16 + (U8)(uintptr_t)arg * STRESS_BITS;
+    U32 i;
+
+    for (i = 0; i < STRESS_ROUNDS; i++) {
+        U8 module_id = first + (U8)(i % STRESS_BITS);
+
+        ww_log_enable_module(module_id);
+        if (!ww_log_is_module_enabled(module_id)) {
+            __atomic_fetch_add(&g_errors, 1, __ATOMIC_RELAXED);
+        }
+        ww_log_set_module_level(module_id, (U8)(i & 3));
+        ww_log_disable_module(module_id);
+        if (ww_log_is_module_enabled(module_id)) {
+            __atomic_fetch_add(&g_errors, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+/* ========== Main ========== */
+
+int main(void)
+{
+    static WW_LOG_SINK_T sinks[2];
+    pthread_t producers[STRESS_PRODUCERS];
+    pthread_t updaters[STRESS_UPDATERS];
+    pthread_t flipper;
+    U32 i;
+
+    ww_log_sink_null_init(&sinks[0]);
+    ww_log_sink_null_init(&sinks[1]);
+    ww_log_sink_add(&sinks[0]);
+    ww_log_sink_add(&sinks[1]);
+    ww_log_set_module_mask(0x0000FFFF & ~(1U << STRESS_MODULE_B));
+    ww_log_set_sink_mask(0x1U);
+    ww_log_init();
+
+    for (i = 0; i < STRESS_PRODUCERS; i++) {
+        pthread_create(&producers[i], NULL, stress_producer, (void *)(uintptr_t)i);
+    }
+    for (i = 0; i < STRESS_UPDATERS; i++) {
+        pthread_create(&updaters[i], NULL, stress_updater, (void *)(uintptr_t)i);
+    }
+    pthread_create(&flipper, NULL, stress_flipper, NULL);
+
+    pthread_join(flipper, NULL);
+    for (i = 0; i < STRESS_UPDATERS; i++) {
+        pthread_join(updaters[i], NULL);
+    }
+    __atomic_store_n(&g_stop, 1, __ATOMIC_RELAXED);
+    for (i = 0; i < STRESS_PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+
+    if ((ww_log_get_module_mask() & 0xFFFF0000U) != 0) {
+        g_errors++;
+    }
+
+    printf("Config stress: %u producers, %u updaters, %u config versions\n",
+           STRESS_PRODUCERS, STRESS_UPDATERS, ww_log_config_current()->version);
+    printf("  snapshots checked: %llu, errors: %u\n",
+           (unsigned long long)g_checked, g_errors);
+
+    return (g_errors == 0) ? 0 : 1;
+}
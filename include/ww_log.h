@@ -12,6 +12,11 @@
  *   LOG_WRN(module_id, fmt, ...)   - Warning level
  *   LOG_INF(module_id, fmt, ...)   - Info level
  *   LOG_DBG(module_id, fmt, ...)   - Debug level
+ *   LOG_HEX(level, data, len)      - Hex dump of a byte buffer
+ *   LOG_XXX_RATELIMIT(fmt, ...)    - Rate limited per call site (ww_log_ratelimit.h)
+ *   LOG_XXX_ONCE(fmt, ...)         - Logged once per call site
+ *   LOG_BATCH_BEGIN/ADD/COMMIT     - Records written together (ww_log_encode.h)
+ *   ww_log_site_set(query, enable) - Switch call sites at runtime (ww_log_site.h)
  *
  * Mode selection is done at compile time via Makefile or build system.
  */
@@ -20,6 +25,7 @@
 #define WW_LOG_H
 
 #include "type.h"
+#include "ww_log_sink.h"
 
 /**
  * Log level definitions
@@ -51,6 +57,21 @@
 #define WW_LOG_COMPILE_THRESHOLD  WW_LOG_LEVEL_DBG  /* Default: compile all logs */
 #endif
 
+/**
+ * Per-module / per-file compile-time threshold
+ *
+ * CURRENT_MODULE_COMPILE_LEVEL is injected by the Makefile from the
+ * "compile_level" of the file or its module in log_config.json. It lowers
+ * WW_LOG_COMPILE_THRESHOLD for the current file only, so e.g. the DBG
+ * calls of one module are compiled out while other modules keep them.
+ * The global threshold stays the upper bound.
+ */
+#if defined(CURRENT_MODULE_COMPILE_LEVEL) && \
+    (CURRENT_MODULE_COMPILE_LEVEL < WW_LOG_COMPILE_THRESHOLD)
+#undef WW_LOG_COMPILE_THRESHOLD
+#define WW_LOG_COMPILE_THRESHOLD  CURRENT_MODULE_COMPILE_LEVEL
+#endif
+
 /**
  * Mode selection: Choose one of the following by uncommenting
  * - WW_LOG_MODE_STR: String mode (printf-style, human-readable)
@@ -65,6 +86,55 @@
 // #define WW_LOG_MODE_ENCODE
 // #define WW_LOG_MODE_DISABLED
 
+/**
+ * RAM ring buffer selection (see ww_log_ram.h)
+ * - WW_LOG_ENCODE_RAM_BUFFER_EN: encode mode records go to the RAM ring
+ * - WW_LOG_ASYNC_EN: records go to the RAM ring and are written out by
+ *   a background drain thread (see ww_log_async.h)
+ */
+#if defined(WW_LOG_MODE_DISABLED)
+    #undef WW_LOG_ASYNC_EN
+#endif
+
+/* Deferred string formatting (see ww_log_str.h) runs in the drain thread */
+#if !defined(WW_LOG_MODE_STR)
+    #undef WW_LOG_STR_DEFERRED_EN
+#endif
+
+#if defined(WW_LOG_STR_DEFERRED_EN) && !defined(WW_LOG_ASYNC_EN)
+    #define WW_LOG_ASYNC_EN
+#endif
+
+/* Waiting for ring space (see ww_log_async.h) needs the drain thread */
+#if !defined(WW_LOG_ASYNC_EN)
+    #undef WW_LOG_ASYNC_BLOCK_EN
+#endif
+
+/* Compact payload, timestamps and sync frames (see ww_log_encode.h) only apply to encode mode */
+#if !defined(WW_LOG_MODE_ENCODE)
+    #undef WW_LOG_ENCODE_COMPACT
+    #undef WW_LOG_ENCODE_TIMESTAMP_EN
+    #undef WW_LOG_ENCODE_SYNC_EN
+#endif
+
+#if (defined(WW_LOG_MODE_ENCODE) && defined(WW_LOG_ENCODE_RAM_BUFFER_EN)) || \
+    defined(WW_LOG_ASYNC_EN)
+    #define WW_LOG_RAM_BUFFER_EN
+#endif
+
+/*
+ * File-backed ring (see ww_log_ram.h) needs the ring, and cannot hold
+ * deferred records: they point into the image of the process that wrote them
+ */
+#if !defined(WW_LOG_RAM_BUFFER_EN) || defined(WW_LOG_STR_DEFERRED_EN)
+    #undef WW_LOG_RAM_PERSIST_EN
+#endif
+
+/* Sync frames need an output stream: not with records kept in the RAM ring only */
+#if defined(WW_LOG_RAM_BUFFER_EN) && !defined(WW_LOG_ASYNC_EN)
+    #undef WW_LOG_ENCODE_SYNC_EN
+#endif
+
 /* Include corresponding implementation */
 #if defined(WW_LOG_MODE_ENCODE)
     #include "ww_log_encode.h"
@@ -76,13 +146,65 @@
     #define LOG_WRN(...)  do { } while(0)
     #define LOG_INF(...)  do { } while(0)
     #define LOG_DBG(...)  do { } while(0)
+    #define LOG_HEX(...)  do { } while(0)
+    #define LOG_ERR_RATELIMIT(...)  do { } while(0)
+    #define LOG_WRN_RATELIMIT(...)  do { } while(0)
+    #define LOG_INF_RATELIMIT(...)  do { } while(0)
+    #define LOG_DBG_RATELIMIT(...)  do { } while(0)
+    #define LOG_ERR_ONCE(...)  do { } while(0)
+    #define LOG_WRN_ONCE(...)  do { } while(0)
+    #define LOG_INF_ONCE(...)  do { } while(0)
+    #define LOG_DBG_ONCE(...)  do { } while(0)
+    #define LOG_BATCH_BEGIN(...)   do { } while(0)
+    #define LOG_BATCH_ADD(...)     do { } while(0)
+    #define LOG_BATCH_COMMIT(...)  do { } while(0)
 #else
     #error "No log mode defined! Please uncomment one mode in ww_log.h"
 #endif
 
+#if !defined(WW_LOG_MODE_DISABLED)
+    #include "ww_log_site.h"
+    #include "ww_log_ratelimit.h"
+#endif
+
+#ifdef WW_LOG_RAM_BUFFER_EN
+    #include "ww_log_ram.h"
+#endif
+
+#ifdef WW_LOG_ASYNC_EN
+    #include "ww_log_async.h"
+#endif
+
+#ifdef WW_LOG_ENCODE_TIMESTAMP_EN
+    #include "ww_log_time.h"
+#endif
+
 /**
- * @brief Initialize log system (optional, for future extensions)
+ * @brief Initialize log system
+ *
+ * Output goes to the sinks registered with ww_log_sink_add() before this
+ * call; when none are registered a stdio sink on stdout is installed.
+ * In async mode this starts the drain thread. ww_log_shutdown() is
+ * registered with atexit() in every mode, so registered sinks must stay
+ * valid until exit (static storage) or be removed before.
  */
 void ww_log_init(void);
 
+/**
+ * @brief Write out everything logged so far
+ *
+ * Async mode: drains the RAM ring on the calling thread and flushes the
+ * output. Sync modes: flushes the output. With WW_LOG_ENCODE_SYNC_EN
+ * a sync frame closes the current block first.
+ */
+void ww_log_flush(void);
+
+/**
+ * @brief Flush and stop background output, then close all sinks
+ *
+ * Safe to call more than once; output logged after shutdown is dropped
+ * because no sink is registered any more.
+ */
+void ww_log_shutdown(void);
+
 #endif /* WW_LOG_H */
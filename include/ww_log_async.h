@@ -0,0 +1,155 @@
+/**
+ * @file ww_log_async.h
+ * @brief Asynchronous output: background drain thread with flush policy
+ * @date 2026-10-16
+ *
+ * Enabled with -DWW_LOG_ASYNC_EN (string and encode mode).
+ *
+ * In async mode the LOG_XXX() caller only copies its record into the
+ * lock-free RAM ring (ww_log_ram.h). A background thread started by
+ * ww_log_init() moves records out of the ring in batches, renders them
+ * and hands each batch to the sinks (ww_log_sink.h) as a single writev.
+ *
+ * The drain thread wakes up when any flush trigger fires:
+ * - flush_bytes:       pending ring data reaches this many bytes
+ * - flush_records:     this many records are pending
+ * - flush_interval_ms: this much time passed since the last drain
+ * - flush_on_err:      an ERR-level record was logged
+ * A trigger value of 0 disables that trigger.
+ *
+ * ww_log_flush() drains synchronously; ww_log_shutdown() drains and stops
+ * the thread and is registered with atexit() by ww_log_init() (in every mode).
+ *
+ * The default flush triggers follow the ring size: the thread is woken
+ * when a quarter of the ring is pending, leaving the rest for the burst
+ * that arrives while it drains. A full ring drops the new record unless
+ * -DWW_LOG_ASYNC_BLOCK_EN is set, which makes the producer wait for the
+ * drain thread instead (never the drain thread itself, and only while it
+ * runs: before ww_log_init() and after ww_log_shutdown() records are
+ * still dropped).
+ */
+
+#ifndef WW_LOG_ASYNC_H
+#define WW_LOG_ASYNC_H
+
+#include "type.h"
+#include "ww_log_ram.h"
+
+/* ========== Default Flush Policy ========== */
+
+#ifndef WW_LOG_ASYNC_FLUSH_BYTES
+#define WW_LOG_ASYNC_FLUSH_BYTES        (WW_LOG_RAM_BUFFER_SIZE * 4 / 4)  /* Quarter ring */
+#endif
+
+#ifndef WW_LOG_ASYNC_FLUSH_RECORDS
+#define WW_LOG_ASYNC_FLUSH_RECORDS      (WW_LOG_RAM_BUFFER_SIZE / 64)  /* Quarter ring of 16-word records */
+#endif
+
+#ifndef WW_LOG_ASYNC_FLUSH_INTERVAL_MS
+#define WW_LOG_ASYNC_FLUSH_INTERVAL_MS  100
+#endif
+
+#ifndef WW_LOG_ASYNC_FLUSH_ON_ERR
+#define WW_LOG_ASYNC_FLUSH_ON_ERR       1
+#endif
+
+/**
+ * Longest rendered line (string mode) stored in one ring record.
+ * A ring record carries at most 63 payload words (6-bit DATA_LEN).
+ */
+#define WW_LOG_ASYNC_LINE_MAX  (63 * 4)
+
+/**
+ * Ring words moved out per drain step (and rendered into one writev);
+ * at least one record (64 words)
+ */
+#ifndef WW_LOG_ASYNC_BATCH_WORDS
+#if WW_LOG_RAM_BUFFER_SIZE < 2048
+#define WW_LOG_ASYNC_BATCH_WORDS  WW_LOG_RAM_BUFFER_SIZE
+#else
+#define WW_LOG_ASYNC_BATCH_WORDS  2048
+#endif
+#endif
+
+/**
+ * Flush policy configuration
+ */
+typedef struct {
+    U32 flush_bytes;        /* Pending bytes trigger (0 = off) */
+    U32 flush_records;      /* Pending record count trigger (0 = off) */
+    U32 flush_interval_ms;  /* Periodic drain interval (0 = off) */
+    U8  flush_on_err;       /* Drain immediately on ERR-level records */
+} WW_LOG_ASYNC_CFG_T;
+
+extern WW_LOG_ASYNC_CFG_T g_ww_log_async_cfg;
+
+/* ========== API Functions ========== */
+
+/**
+ * @brief Start the drain thread (called by ww_log_init())
+ * @return 0 on success, -1 if the thread could not be created
+ */
+S8 ww_log_async_start(void);
+
+/**
+ * @brief Replace the flush policy
+ * @param cfg New policy (copied)
+ */
+void ww_log_async_set_config(const WW_LOG_ASYNC_CFG_T *cfg);
+
+/**
+ * @brief Read the current flush policy
+ * @param cfg Output
+ */
+void ww_log_async_get_config(WW_LOG_ASYNC_CFG_T *cfg);
+
+/**
+ * @brief Wake the drain thread (producer side, rarely taken)
+ */
+void ww_log_async_kick(void);
+
+/**
+ * @brief Wait for the drain thread to free ring space (WW_LOG_ASYNC_BLOCK_EN)
+ * @return 0 when the claim should be retried, -1 when the record must be
+ *         dropped (drain thread not running, or called by it)
+ *
+ * Wakes the drain thread and sleeps until it has moved a batch out of the
+ * ring (at most 1 ms, so a missed wakeup only costs a retry).
+ */
+S8 ww_log_async_wait(void);
+
+/**
+ * @brief Check the flush triggers after a record was published
+ * @param end Ring position just past the published record
+ * @param level Level of the published record
+ *
+ * Fast path is a few loads and compares; the drain thread is only
+ * signalled when a trigger fires.
+ */
+static inline void ww_log_async_notify(U32 end, U8 level)
+{
+    U32 pending_words = end - __atomic_load_n(&g_ww_log_ram_buffer.head, __ATOMIC_RELAXED);
+    U32 pending_records = __atomic_load_n(&g_ww_log_ram_buffer.records_in, __ATOMIC_RELAXED) -
+                          __atomic_load_n(&g_ww_log_ram_buffer.records_out, __ATOMIC_RELAXED);
+
+    if ((level == 0 && g_ww_log_async_cfg.flush_on_err) ||
+        (g_ww_log_async_cfg.flush_bytes != 0 &&
+         pending_words * 4 >= g_ww_log_async_cfg.flush_bytes) ||
+        (g_ww_log_async_cfg.flush_records != 0 &&
+         pending_records >= g_ww_log_async_cfg.flush_records)) {
+        ww_log_async_kick();
+    }
+}
+
+/**
+ * @brief Render one ring record as output text (mode specific)
+ * @param rec Record words (header first)
+ * @param out Output buffer
+ * @param size Output buffer size
+ * @return Number of bytes written to out (no terminating NUL)
+ *
+ * Implemented by ww_log_str.c or ww_log_encode.c depending on the mode.
+ */
+U32 ww_log_async_render(const U32 *rec, char *out, U32 size);
+
+#endif /* WW_LOG_ASYNC_H */
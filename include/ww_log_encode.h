@@ -1,15 +1,24 @@
 /**
  * @file ww_log_encode.h
- * @brief Encode mode logging implementation (variadic function version with auto module ID)
+ * @brief Encode mode logging implementation (fixed-arity/variadic functions with auto module ID)
  * @date 2025-12-17
  * Encode mode features:
  * - Binary encoding for minimal code size
  * - No format strings stored in ROM (fmt parameter is discarded)
- * - Variadic function for minimal macro expansion
+ * - Fixed-arity functions for 0-4 parameters, variadic function above that
  * - All filtering done in function
  * - Module ID automatically determined from CURRENT_MODULE_ID
  *
- * Encoding Layout (32 bits):
+ * Encoding Layout v2 (default, 2 words):
+ * ┌──────────────────┬────────────┬──────────────┬────────┐
+ * │ LOG_ID           │ FLAGS      │ DATA_LEN     │ LEVEL  │
+ * │ (16 bits)        │ (8 bits)   │ (6 bits)     │(2 bits)│
+ * │ 31            16 │ 15       8 │ 7          2 │ 1    0 │
+ * ├──────────────────┴────────────┴──────────────┴────────┤
+ * │ LINE (32 bits)                                        │
+ * └───────────────────────────────────────────────────────┘
+ *
+ * Encoding Layout v1 (WW_LOG_ENCODE_V1, 32 bits):
  * ┌─────────────┬─────────────┬──────────────┬────----┐
  * │ LOG_ID      │ LINE        │ DATA_LEN     │ LEVEL  │
  * │ (12 bits)   │ (12 bits)   │ (6 bits)     │(2 bits)│
@@ -32,13 +41,37 @@
 
 /**
  * Extract module ID from LOG_ID
- * Since each module reserves 64 slots (DIR_BASE = module_id << 6),
- * we can extract module_id by shifting right by 6 bits
+ * Each module reserves WW_LOG_FILES_PER_MODULE IDs (base_id = module_id * 64
+ * by default), so the module is the quotient
  */
-#define WW_LOG_GET_MODULE_ID(log_id)  ((log_id) >> 6)
+#define WW_LOG_GET_MODULE_ID(log_id)  ((log_id) / WW_LOG_FILES_PER_MODULE)
 
 /* ========== Encoding Macros ========== */
 
+/**
+ * Header format versions:
+ * - v2 (default): word 0 keeps DATA_LEN and LEVEL at their v1 positions,
+ *   LOG_ID grows to 16 bits (1023 modules of 64 files) and LINE moves to
+ *   a word of its own. DATA_LEN counts the words after word 0 - the LINE
+ *   word plus up to 62 payload words - so the RAM ring and the decoder
+ *   frame both versions as 1 + DATA_LEN words, and word 0 is never 0.
+ *   FLAGS bit 0 marks typed records (WW_LOG_HDR_FLAG_EXT).
+ * - v1 (WW_LOG_ENCODE_V1): one word per header, the compact option for
+ *   small targets: at most 32 modules, lines above 4095 wrap.
+ * The stream header carries the version, so the decoder picks the layout.
+ *
+ * Call sites pass the header as one compile-time constant WW_LOG_HDR_T
+ * (v2: word 0 in the low half, LINE in the high half). The macros below
+ * take and return WW_LOG_HDR_T; DATA_LEN is always the payload length.
+ */
+#ifdef WW_LOG_ENCODE_V1
+
+typedef U32 WW_LOG_HDR_T;
+
+#define WW_LOG_HDR_VERSION   1
+#define WW_LOG_HDR_WORDS     1      /* Header words per record */
+#define WW_LOG_FILE_ID_LIMIT 0x7FF  /* File IDs below this (bit 11 = typed flag) */
+
 /**
  * Encode a log entry into 32-bit format
  */
@@ -53,32 +86,373 @@
 /**
  * Decode macros to extract fields from encoded log
  */
-// #define WW_LOG_DECODE_LOG_ID(encoded)      (((encoded) >> 20) & 0xFFF)
-// #define WW_LOG_DECODE_LINE(encoded)        (((encoded) >> 8) & 0xFFF)
-// #define WW_LOG_DECODE_DATA_LEN(encoded)    (((encoded) >> 2) & 0x3F)
-// #define WW_LOG_DECODE_LEVEL(encoded)       ((encoded) & 0x3)
+#define WW_LOG_DECODE_LOG_ID(encoded)      (((encoded) >> 20) & 0xFFF)
+#define WW_LOG_DECODE_LINE(encoded)        (((encoded) >> 8) & 0xFFF)
+#define WW_LOG_DECODE_DATA_LEN(encoded)    (((encoded) >> 2) & 0x3F)
+#define WW_LOG_DECODE_LEVEL(encoded)       ((encoded) & 0x3)
+#define WW_LOG_DECODE_EXT(encoded)         (((encoded) >> 31) & 0x1)
+#define WW_LOG_DECODE_FILE_ID(encoded)     (((encoded) >> 20) & 0x7FF)
+
+/**
+ * Replace the DATA_LEN field of a header
+ */
+#define WW_LOG_ENCODE_SET_DATA_LEN(encoded, data_len) \
+    (((U32)(encoded) & ~(0x3FU << 2)) | (((U32)(data_len) & 0x3F) << 2))
+
+/**
+ * Mark a header as typed record (see WW_LOG_ENCODE_EXT_FLAG)
+ */
+#define WW_LOG_ENCODE_SET_EXT(encoded)  ((encoded) | (1U << 31))
+
+#else /* v2 */
+
+typedef U64 WW_LOG_HDR_T;
+
+#define WW_LOG_HDR_VERSION   2
+#define WW_LOG_HDR_WORDS     2
+#define WW_LOG_FILE_ID_LIMIT 0xFFFF
+
+#define WW_LOG_HDR_FLAG_EXT  (1U << 8)  /* FLAGS bit 0: typed record */
+
+#define WW_LOG_ENCODE(log_id, line, data_len, level) \
+    ((U64)( \
+        ((U64)(U32)(line) << 32) | \
+        (((U32)(log_id) & 0xFFFF) << 16) | \
+        ((((U32)(data_len) + 1) & 0x3F) << 2) | \
+        ((U32)(level) & 0x3) \
+    ))
+
+#define WW_LOG_DECODE_LOG_ID(encoded)      (((U32)(encoded) >> 16) & 0xFFFF)
+#define WW_LOG_DECODE_LINE(encoded)        ((U32)((U64)(encoded) >> 32))
+#define WW_LOG_DECODE_DATA_LEN(encoded)    ((((U32)(encoded) >> 2) & 0x3F) - 1)
+#define WW_LOG_DECODE_LEVEL(encoded)       ((U32)(encoded) & 0x3)
+#define WW_LOG_DECODE_EXT(encoded)         (((U32)(encoded) & WW_LOG_HDR_FLAG_EXT) ? 1 : 0)
+#define WW_LOG_DECODE_FILE_ID(encoded)     WW_LOG_DECODE_LOG_ID(encoded)
+
+#define WW_LOG_ENCODE_SET_DATA_LEN(encoded, data_len) \
+    (((U64)(encoded) & ~(U64)(0x3FU << 2)) | ((((U32)(data_len) + 1) & 0x3F) << 2))
+
+#define WW_LOG_ENCODE_SET_EXT(encoded)  ((U64)(encoded) | WW_LOG_HDR_FLAG_EXT)
+
+#endif /* WW_LOG_ENCODE_V1 */
+
+/**
+ * Header words as written to the output (word 0 first)
+ */
+#define WW_LOG_HDR_WORD(encoded, i)  ((U32)((U64)(encoded) >> ((i) * 32)))
+
+/**
+ * Words of the record starting with header word 0 (1 + DATA_LEN field,
+ * same for both versions)
+ */
+#define WW_LOG_REC_WORDS(word0)  (1U + (((U32)(word0) >> 2) & 0x3F))
+
+/**
+ * Largest payload of one record (6-bit DATA_LEN field, minus the LINE
+ * word in v2)
+ */
+#define WW_LOG_PAYLOAD_MAX  (64 - WW_LOG_HDR_WORDS)
+
+/* ========== Typed Parameters ========== */
+
+/**
+ * Records with 64-bit, pointer, floating-point or string parameters are
+ * written as typed records:
+ * - v1: LOG_ID has WW_LOG_ENCODE_EXT_FLAG (bit 11) set; file IDs stay
+ *   below 2048 (32 modules x 64 files), so the bit is otherwise unused.
+ *   v2: FLAGS has WW_LOG_HDR_FLAG_EXT set. WW_LOG_ENCODE_SET_EXT() sets
+ *   the flag of either version.
+ * - The payload starts with descriptor words, each carrying the type tags
+ *   of 10 parameters (3 bits each, parameter 0 in bits 2-0). Bit 31 set
+ *   means another descriptor word follows.
+ * - The parameter values follow, 1 word for 32-bit types and 2 words
+ *   (low word first) for 64-bit types
+ * DATA_LEN counts all payload words (descriptors + values).
+ *
+ * Records whose parameters are all 32-bit or narrower keep the plain
+ * format (no descriptor).
+ */
+#define WW_LOG_ENCODE_EXT_FLAG    0x800
+#define WW_LOG_EXT_TAGS_PER_WORD  10
+#define WW_LOG_EXT_DESC_MORE      (1U << 31)
+
+/* Parameter type tags */
+#define WW_LOG_TAG_U32    0  /* Integers up to 32 bits */
+#define WW_LOG_TAG_U64    1  /* 64-bit integers */
+#define WW_LOG_TAG_F32    2  /* float (IEEE 754 single bits) */
+#define WW_LOG_TAG_F64    3  /* double (IEEE 754 double bits) */
+#define WW_LOG_TAG_PTR32  4  /* Pointer on a 32-bit target */
+#define WW_LOG_TAG_PTR64  5  /* Pointer on a 64-bit target */
+#define WW_LOG_TAG_STR    6  /* String (char * / const char *) */
+#define WW_LOG_TAG_BITS   3
+
+/* ========== String Parameters ========== */
+
+/**
+ * char * and const char * parameters get WW_LOG_TAG_STR. Their first
+ * payload item tells the two forms apart:
+ * - String literal: (id << 1) | 1. The literal is placed in the
+ *   "ww_log_strtab" section at the call site and id is its byte offset
+ *   there; the build extracts the section to build/log_strtab.bin for
+ *   the decoder (objcopy). Only the ID is logged.
+ * - Any other string: (len << 2) | (truncated << 1), followed by len
+ *   bytes (plain: ceil(len / 4) words, byte k in bits 8*(k%4).. of word
+ *   k/4; compact: raw bytes). At most WW_LOG_STR_ARG_MAX bytes are
+ *   copied, fewer if the record would exceed WW_LOG_PAYLOAD_MAX words.
+ */
+#ifndef WW_LOG_STR_ARG_MAX
+#define WW_LOG_STR_ARG_MAX  32
+#endif
+
+#define WW_LOG_STR_ID_FLAG     1U         /* Item is an interned string ID */
+#define WW_LOG_STR_TRUNC_FLAG  (1U << 1)  /* Runtime string was cut off */
+
+/* ========== Data Blocks ========== */
+
+/**
+ * LOG_HEX(level, data, len) writes a byte buffer as one or more blob
+ * records, WW_LOG_BLOB_CHUNK_MAX bytes each. A blob record is a typed
+ * record (WW_LOG_ENCODE_SET_EXT) whose descriptor has the tag
+ * WW_LOG_TAG_BLOB in bits 2-0:
+ *   [timestamp][descriptor][total length][bytes...]
+ * - descriptor: WW_LOG_BLOB_DESC(offset, chunk length)
+ * - the bytes start on a word boundary (compact: the items before them
+ *   are padded with WW_LOG_COMPACT_PAD) and are copied with one memcpy;
+ *   byte k is bits 8*(k%4)+7..8*(k%4) of word k/4, the rest of the last
+ *   word is 0
+ * The decoder prints each chunk as a hex dump with its offset.
+ * Buffers longer than WW_LOG_BLOB_MAX_LEN are cut off there.
+ */
+#define WW_LOG_TAG_BLOB          7
+#define WW_LOG_BLOB_CHUNK_MAX    ((WW_LOG_PAYLOAD_MAX - 4) * 4)  /* Minus a 4-word prefix */
+#define WW_LOG_BLOB_MAX_LEN      0xFFFFF  /* 20-bit offset */
+
+#define WW_LOG_BLOB_DESC(offset, chunk) \
+    ((U32)WW_LOG_TAG_BLOB | (((U32)(chunk) & 0xFF) << 3) | (((U32)(offset) & 0xFFFFF) << 11))
+
+/* ========== Control Records ========== */
+
+/**
+ * Records written by the log system itself use LOG_ID WW_LOG_CTRL_LOG_ID
+ * (v1: file ID 0x7FF with WW_LOG_ENCODE_EXT_FLAG, v2: 0xFFFF; reserved)
+ * and carry the control type in the LINE field. Their payload is always
+ * plain words (no timestamp item, not compacted):
+ * - WW_LOG_CTRL_CALIB: clock calibration (see ww_log_time.h)
+ * - WW_LOG_CTRL_SYNC:  timestamp sync point [epoch][base lo][base hi]
+ * - WW_LOG_CTRL_DROP:  [records dropped] since the previous marker
+ *                      (WW_LOG_RAM_DROP_HDR, written by the RAM ring)
+ * - WW_LOG_CTRL_SUPPRESS: [site header words][records suppressed] by the
+ *                      rate limit of that call site (see ww_log_ratelimit.h)
+ */
+#ifdef WW_LOG_ENCODE_V1
+#define WW_LOG_CTRL_LOG_ID    0xFFF
+#else
+#define WW_LOG_CTRL_LOG_ID    0xFFFF
+#endif
+#define WW_LOG_CTRL_CALIB     1
+#define WW_LOG_CTRL_SYNC      2
+#define WW_LOG_CTRL_DROP      3
+#define WW_LOG_CTRL_SUPPRESS  4
+
+/**
+ * @brief Write a control record (not filtered)
+ * @param type WW_LOG_CTRL_xxx
+ * @param words Payload words
+ * @param count Number of payload words (0 .. WW_LOG_PAYLOAD_MAX)
+ * @return 0 if written, -1 if dropped because the RAM ring is full
+ */
+S8 ww_log_encode_control(U16 type, const U32 *words, U32 count);
+
+/* ========== Compact Payload (Optional) ========== */
+
+/**
+ * With WW_LOG_ENCODE_COMPACT the payload of every record is a byte stream
+ * instead of one word per parameter:
+ * - 32-bit parameters: zigzag + LEB128 (small counters, IDs and small
+ *   negative values take 1 byte)
+ * - Typed records: descriptor words as LEB128, 64-bit integers zigzag +
+ *   LEB128, pointers LEB128, float/double as 4/8 raw bytes
+ * Byte k of the payload is bits 8*(k%4)+7..8*(k%4) of payload word k/4.
+ * DATA_LEN still counts payload words, so the ring keeps its framing;
+ * the unused bytes of the last word are WW_LOG_COMPACT_PAD, which never
+ * terminates a LEB128 value, so the decoder stops there.
+ * The stream header carries WW_LOG_STREAM_FLAG_COMPACT.
+ */
+#define WW_LOG_COMPACT_PAD  0x80
+
+#define WW_LOG_ZIGZAG32(v)  ((((U32)(v)) << 1) ^ (U32)((S32)(v) >> 31))
+#define WW_LOG_ZIGZAG64(v)  ((((U64)(v)) << 1) ^ (U64)((S64)(v) >> 63))
+
+/* ========== Output Stream Format ========== */
+
+/**
+ * Output format selection:
+ * - Default: hex text, one record per line
+ *     0xHHHHHHHH 0xPPPPPPPP 0xPPPPPPPP ...
+ * - WW_LOG_ENCODE_OUTPUT_BIN: raw U32 words in native byte order,
+ *   header word 0 followed by DATA_LEN words, no separators
+ *
+ * Both formats start with a stream header written by ww_log_init():
+ * ┌──────────────────────┬──────────────────────────────┬──────────────────┐
+ * │ WW_LOG_STREAM_MAGIC  │ FLAGS (31-16) | VERSION (15-0)│ WW_LOG_STREAM_BOM│
+ * └──────────────────────┴──────────────────────────────┴──────────────────┘
+ * The byte order mark lets the decoder read binary captures from
+ * big-endian targets as well. VERSION is the record header version
+ * (WW_LOG_HDR_VERSION), so one decoder reads v1 and v2 streams.
+ */
+#define WW_LOG_STREAM_MAGIC      0x574C4753  /* "WLGS" */
+#define WW_LOG_STREAM_VERSION    WW_LOG_HDR_VERSION
+#define WW_LOG_STREAM_BOM        0x01020304
+
+#define WW_LOG_STREAM_FLAG_BIN      (1U << 0)   /* Raw binary words */
+#define WW_LOG_STREAM_FLAG_COMPACT  (1U << 1)   /* Compact payload */
+#define WW_LOG_STREAM_FLAG_TS       (1U << 2)   /* Timestamp item per record */
+#define WW_LOG_STREAM_FLAG_SYNC     (1U << 3)   /* Sync frames (WW_LOG_ENCODE_SYNC_EN) */
+
+#ifdef WW_LOG_ENCODE_OUTPUT_BIN
+#define WW_LOG_STREAM_FLAG_BIN_SEL      WW_LOG_STREAM_FLAG_BIN
+#else
+#define WW_LOG_STREAM_FLAG_BIN_SEL      0
+#endif
+
+#ifdef WW_LOG_ENCODE_COMPACT
+#define WW_LOG_STREAM_FLAG_COMPACT_SEL  WW_LOG_STREAM_FLAG_COMPACT
+#else
+#define WW_LOG_STREAM_FLAG_COMPACT_SEL  0
+#endif
+
+#ifdef WW_LOG_ENCODE_TIMESTAMP_EN
+#define WW_LOG_STREAM_FLAG_TS_SEL       WW_LOG_STREAM_FLAG_TS
+#else
+#define WW_LOG_STREAM_FLAG_TS_SEL       0
+#endif
+
+#ifdef WW_LOG_ENCODE_SYNC_EN
+#define WW_LOG_STREAM_FLAG_SYNC_SEL     WW_LOG_STREAM_FLAG_SYNC
+#else
+#define WW_LOG_STREAM_FLAG_SYNC_SEL     0
+#endif
+
+#define WW_LOG_STREAM_FLAGS  (WW_LOG_STREAM_FLAG_BIN_SEL | WW_LOG_STREAM_FLAG_COMPACT_SEL | \
+                              WW_LOG_STREAM_FLAG_TS_SEL | WW_LOG_STREAM_FLAG_SYNC_SEL)
+
+/**
+ * @brief Write the stream header to the output (called by ww_log_init())
+ */
+void ww_log_encode_stream_start(void);
+
+/* ========== Stream Sync Frames (Optional) ========== */
+
+/**
+ * With WW_LOG_ENCODE_SYNC_EN the output stream is cut into blocks of at
+ * most WW_LOG_SYNC_INTERVAL records, each closed by a sync frame:
+ * ┌──────────────────────┬──────────────┬──────────────────────────────┐
+ * │ WW_LOG_SYNC_MAGIC    │ SEQ          │ CRC32C of the block          │
+ * └──────────────────────┴──────────────┴──────────────────────────────┘
+ * - The block is every record word written since the previous frame (or
+ *   the stream header); the CRC runs over the word values, low byte
+ *   first, so text and binary output of one block have the same CRC
+ * - SEQ counts frames from 0, a jump tells the decoder blocks were lost
+ * - CRC32C (Castagnoli): the SSE4.2 / ARMv8 CRC32C instruction when the
+ *   target has it (-msse4.2, -march=armv8-a+crc), 4 KB of lookup tables
+ *   (slicing by 4) otherwise
+ *
+ * When a word or a byte is lost or damaged (noisy UART), the decoder
+ * throws away the block whose CRC does not match and continues with the
+ * records after the next good frame, instead of misreading DATA_LEN for
+ * the rest of the stream. Binary captures are searched byte by byte, so
+ * the stream re-aligns after a lost byte as well.
+ *
+ * Frames are only written where records reach the output (direct output
+ * or async mode, not the RAM ring alone); ww_log_flush() closes the
+ * current block so everything flushed can be checked.
+ */
+#define WW_LOG_SYNC_MAGIC  0x574C5346  /* "WLSF" */
+
+#ifndef WW_LOG_SYNC_INTERVAL
+#define WW_LOG_SYNC_INTERVAL  32  /* Records per block */
+#endif
+
+#ifdef WW_LOG_ENCODE_SYNC_EN
+/**
+ * @brief Close the current block with a sync frame (no-op if it is empty)
+ *
+ * Async mode: caller holds the drain lock (see ww_log_flush()).
+ */
+void ww_log_encode_sync(void);
+#endif
 
 /* ========== Output Function Declaration ========== */
 
 /**
  * @brief Core encode mode output function (variadic version)
- * @param module_id Module ID (0-31) for filtering
- * @param log_id File identifier (12 bits, 0-4095)
+ * @param module_id Module ID for filtering (implied by log_id)
+ * @param log_id File identifier (below WW_LOG_FILE_ID_LIMIT)
  * @param line Source line number
  * @param level Log level (0-3)
  * @param param_count Number of parameters (0-16)
  * @param ... Variable parameters (each as U32)
  *
  * This function performs all filtering internally:
- * - Module enable check (via g_ww_log_module_mask)
- * - Level threshold check (via g_ww_log_level_threshold)
+ * - Module enable and module / file level threshold check
+ *   (via the level table of the configuration snapshot)
  *
  * Parameters are extracted via va_list inside the function,
  * eliminating the need to create arrays at each call site.
+ * LOG_XXX() only uses it for more than 4 parameters.
  */
-void ww_log_encode_output(U8 module_id, U16 log_id, U16 line, U8 level,
+void ww_log_encode_output(U16 module_id, U16 log_id, U32 line, U8 level,
                 U8 param_count, ...);
 
+/**
+ * @brief Fixed-arity output functions for 0-4 parameters
+ * @param header Complete record header, WW_LOG_ENCODE(log_id, line, N, level)
+ * @param p0..p3 Parameters
+ *
+ * The header is a compile-time constant at every call site, so a call is
+ * one immediate load plus the parameters - with a v1 header all in
+ * argument registers even with 4 parameters on ARM (a v2 header takes
+ * two registers there). Module ID and level for filtering are taken
+ * from the header (see WW_LOG_GET_MODULE_ID), no va_list is involved.
+ */
+void ww_log_encode_output0(WW_LOG_HDR_T header);
+void ww_log_encode_output1(WW_LOG_HDR_T header, U32 p0);
+void ww_log_encode_output2(WW_LOG_HDR_T header, U32 p0, U32 p1);
+void ww_log_encode_output3(WW_LOG_HDR_T header, U32 p0, U32 p1, U32 p2);
+void ww_log_encode_output4(WW_LOG_HDR_T header, U32 p0, U32 p1, U32 p2, U32 p3);
+
+/**
+ * @brief Output function for typed records (see WW_LOG_ENCODE_EXT_FLAG)
+ * @param header WW_LOG_ENCODE(log_id, line, param_count, level)
+ * @param tags Type tag of parameter i in bits 3i+2..3i (compile-time constant)
+ * @param ... Parameters; float is read as double, 64-bit types at full width
+ *
+ * Used by LOG_XXX() when at least one parameter is wider than 32 bits
+ * or is a pointer, floating-point value or string.
+ */
+void ww_log_encode_output_ext(WW_LOG_HDR_T header, U64 tags, ...);
+
+/**
+ * @brief Output function for data blocks (see WW_LOG_TAG_BLOB)
+ * @param header WW_LOG_ENCODE(log_id, line, 0, level)
+ * @param data Bytes to log
+ * @param len Number of bytes
+ *
+ * Used by LOG_HEX(). The module and level switches are checked once for
+ * the whole block.
+ */
+void ww_log_encode_hex(WW_LOG_HDR_T header, const void *data, U32 len);
+
+/**
+ * @brief Report the records suppressed by a call site's rate limit
+ * @param header WW_LOG_ENCODE(log_id, line, 0, level) of the call site
+ * @param suppressed Suppressed counter of the site (taken and reset)
+ *
+ * Writes a WW_LOG_CTRL_SUPPRESS record if the count is not 0 and the
+ * site passes the module and level switches.
+ */
+void ww_log_encode_suppressed(WW_LOG_HDR_T header, U32 *suppressed);
+
 /* ========== Argument Counting Macro ========== */
 
 /**
@@ -101,12 +475,17 @@ void ww_log_encode_output(U8 module_id, U16 log_id, U16 line, U8 level,
  * - it is NOT compiled into the binary!
  * Macro expansion is minimal - just a single function call:
  *   LOG_INF("val=%d", 123)
- *   -> ww_log_encode_output(CURRENT_MODULE_ID, CURRENT_FILE_ID, __LINE__, 2, 1, 123)
+ *   -> ww_log_encode_output1(WW_LOG_ENCODE(CURRENT_FILE_ID, __LINE__, 1, 2), 123)
+ *   LOG_INF("%d %d %d %d %d", 1, 2, 3, 4, 5)
+ *   -> ww_log_encode_output(CURRENT_MODULE_ID, CURRENT_FILE_ID, __LINE__, 2, 5, 1, 2, 3, 4, 5)
  *
  * Usage:
  *   LOG_ERR("message")              -> 0 params
  *   LOG_INF("val=%d", 123)          -> 1 param
  *   LOG_DBG("x=%d y=%d", 10, 20)    -> 2 params
+ *   LOG_INF("t=%llu p=%p", ns, buf) -> typed record (64-bit + pointer)
+ *   LOG_INF("open %s", path)        -> typed record (string copied)
+ *   LOG_INF("mode %s", "fast")      -> typed record (string table ID)
  *
  * Static Module Switch:
  *   - Each module can be disabled at compile time via WW_LOG_STATIC_MODULE_XXX_EN=0
@@ -127,13 +506,172 @@ void ww_log_encode_output(U8 module_id, U16 log_id, U16 line, U8 level,
 // #define CURRENT_FILE_ID  0
 // #endif
 
+/**
+ * The fixed-arity entry points derive the module from the file ID, so the
+ * file ID must lie in the 64-slot range of its module
+ */
+#if defined(CURRENT_FILE_ID) && defined(CURRENT_MODULE_ID)
+#if WW_LOG_GET_MODULE_ID(CURRENT_FILE_ID) != CURRENT_MODULE_ID
+#error "CURRENT_FILE_ID is outside the ID range of CURRENT_MODULE_ID (base_id must be id * WW_LOG_FILES_PER_MODULE)"
+#endif
+#if CURRENT_FILE_ID >= WW_LOG_FILE_ID_LIMIT
+#error "CURRENT_FILE_ID does not fit the record header (v1 headers: at most 32 modules)"
+#endif
+#endif
+
+/**
+ * Record header of the current call site (compile-time constant)
+ */
+#define _WW_LOG_ENCODE_HDR(level, count) \
+    WW_LOG_ENCODE(CURRENT_FILE_ID, __LINE__, count, level)
+
+/**
+ * String arguments (compile-time constants, argument not evaluated):
+ * _WW_LOG_STR_EXPR() is the argument when it is a string and "" otherwise,
+ * so the interning code below stays valid for every argument type.
+ * A literal is a constant char array; char arrays and pointers that are
+ * not literals are copied at run time.
+ */
+#define _WW_LOG_IS_STR(x)    _Generic((x), char *: 1, const char *: 1, default: 0)
+#define _WW_LOG_STR_EXPR(x)  _Generic((x), char *: (x), const char *: (x), default: "")
+#define _WW_LOG_IS_LITERAL(x) \
+    (_WW_LOG_IS_STR(x) && __builtin_constant_p(_WW_LOG_STR_EXPR(x)) && \
+     !__builtin_types_compatible_p(__typeof__(_WW_LOG_STR_EXPR(x)), char *) && \
+     !__builtin_types_compatible_p(__typeof__(_WW_LOG_STR_EXPR(x)), const char *))
+
+/**
+ * Place a string literal in the string table section, yields its copy there
+ */
+#define _WW_LOG_INTERN(x) ({ \
+    static const char _ww_log_str[] __attribute__((section("ww_log_strtab"))) = \
+        __builtin_choose_expr(_WW_LOG_IS_LITERAL(x), _WW_LOG_STR_EXPR(x), ""); \
+    _ww_log_str; })
+
+#define _WW_LOG_STR_ARG(x) \
+    __builtin_choose_expr(_WW_LOG_IS_LITERAL(x), _WW_LOG_INTERN(x), _WW_LOG_STR_EXPR(x))
+
+/**
+ * Type tag of one argument (compile-time constant, argument not evaluated)
+ * __builtin_classify_type: 5 = pointer (arrays decay), 8 = real
+ */
+#define _WW_LOG_TAG(x) \
+    (_WW_LOG_IS_STR(x) ? WW_LOG_TAG_STR : \
+     __builtin_classify_type(x) == 5 ? \
+        (sizeof(void *) > 4 ? WW_LOG_TAG_PTR64 : WW_LOG_TAG_PTR32) : \
+     __builtin_classify_type(x) == 8 ? \
+        (sizeof(x) == 4 ? WW_LOG_TAG_F32 : WW_LOG_TAG_F64) : \
+     (sizeof(x) > 4 ? WW_LOG_TAG_U64 : WW_LOG_TAG_U32))
+
+/**
+ * Type tags of all arguments, argument 0 in the lowest bits
+ * (0 when every argument is a plain 32-bit value)
+ */
+#define _WW_LOG_TAGS(...) \
+    _WW_LOG_CAT(_WW_LOG_TAGS_, _WW_LOG_ARG_COUNT(__VA_ARGS__))(__VA_ARGS__)
+
+#define _WW_LOG_TAGS_1(a)       ((U64)_WW_LOG_TAG(a))
+#define _WW_LOG_TAGS_2(a, ...)  (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_1(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_3(a, ...)  (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_2(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_4(a, ...)  (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_3(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_5(a, ...)  (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_4(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_6(a, ...)  (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_5(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_7(a, ...)  (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_6(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_8(a, ...)  (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_7(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_9(a, ...)  (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_8(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_10(a, ...) (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_9(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_11(a, ...) (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_10(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_12(a, ...) (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_11(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_13(a, ...) (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_12(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_14(a, ...) (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_13(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_15(a, ...) (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_14(__VA_ARGS__) << WW_LOG_TAG_BITS))
+#define _WW_LOG_TAGS_16(a, ...) (_WW_LOG_TAGS_1(a) | (_WW_LOG_TAGS_15(__VA_ARGS__) << WW_LOG_TAG_BITS))
+
+/**
+ * Argument as a 32-bit word for the fixed-arity entry points
+ * (also valid for the wide types, whose branch is never selected)
+ */
+#define _WW_LOG_W(x)  ((U32)(uintptr_t)(x))
+
+/**
+ * Argument for ww_log_encode_output_ext(): long double is narrowed to
+ * double, string literals are replaced by their string table copy,
+ * everything else is passed unchanged
+ */
+#define _WW_LOG_EXT_ARG(x) \
+    _Generic((x), long double: (double)_Generic((x), long double: (x), default: 0.0), \
+                  char *: _WW_LOG_STR_ARG(x), const char *: _WW_LOG_STR_ARG(x), \
+                  default: (x))
+
+#define _WW_LOG_EXT_ARGS(...) \
+    _WW_LOG_CAT(_WW_LOG_EXT_ARGS_, _WW_LOG_ARG_COUNT(__VA_ARGS__))(__VA_ARGS__)
+
+#define _WW_LOG_EXT_ARGS_1(a)       _WW_LOG_EXT_ARG(a)
+#define _WW_LOG_EXT_ARGS_2(a, ...)  _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_1(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_3(a, ...)  _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_2(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_4(a, ...)  _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_3(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_5(a, ...)  _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_4(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_6(a, ...)  _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_5(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_7(a, ...)  _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_6(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_8(a, ...)  _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_7(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_9(a, ...)  _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_8(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_10(a, ...) _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_9(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_11(a, ...) _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_10(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_12(a, ...) _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_11(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_13(a, ...) _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_12(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_14(a, ...) _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_13(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_15(a, ...) _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_14(__VA_ARGS__)
+#define _WW_LOG_EXT_ARGS_16(a, ...) _WW_LOG_EXT_ARG(a), _WW_LOG_EXT_ARGS_15(__VA_ARGS__)
+
 /**
  * Internal macro to call log output function
- * This is the actual implementation that calls ww_log_encode_output
+ * Dispatches on the argument count and types, all at compile time:
+ * - any argument wider than 32 bits, pointer or floating point:
+ *   ww_log_encode_output_ext() with the type tags
+ * - otherwise 0-4 parameters go to the fixed-arity ww_log_encode_outputN(),
+ *   more fall back to variadic ww_log_encode_output()
  */
 #define _WW_LOG_ENCODE_CALL(level, fmt, ...) \
-    ww_log_encode_output(CURRENT_MODULE_ID, CURRENT_FILE_ID, __LINE__, level, \
-                         _WW_LOG_ARG_COUNT(__VA_ARGS__), ##__VA_ARGS__)
+    _WW_LOG_CAT(_WW_LOG_ENCODE_CALL_, _WW_LOG_ARG_COUNT(__VA_ARGS__))(level, ##__VA_ARGS__)
+
+/* Select between the plain call and the typed call */
+#define _WW_LOG_ENCODE_TYPED(level, plain, ...) \
+    __builtin_choose_expr(_WW_LOG_TAGS(__VA_ARGS__) == 0, plain, \
+        ww_log_encode_output_ext(_WW_LOG_ENCODE_HDR(level, _WW_LOG_ARG_COUNT(__VA_ARGS__)), \
+                                 _WW_LOG_TAGS(__VA_ARGS__), _WW_LOG_EXT_ARGS(__VA_ARGS__)))
+
+#define _WW_LOG_ENCODE_CALL_0(level) \
+    ww_log_encode_output0(_WW_LOG_ENCODE_HDR(level, 0))
+#define _WW_LOG_ENCODE_CALL_1(level, a) \
+    _WW_LOG_ENCODE_TYPED(level, \
+        ww_log_encode_output1(_WW_LOG_ENCODE_HDR(level, 1), _WW_LOG_W(a)), a)
+#define _WW_LOG_ENCODE_CALL_2(level, a, b) \
+    _WW_LOG_ENCODE_TYPED(level, \
+        ww_log_encode_output2(_WW_LOG_ENCODE_HDR(level, 2), _WW_LOG_W(a), _WW_LOG_W(b)), a, b)
+#define _WW_LOG_ENCODE_CALL_3(level, a, b, c) \
+    _WW_LOG_ENCODE_TYPED(level, \
+        ww_log_encode_output3(_WW_LOG_ENCODE_HDR(level, 3), _WW_LOG_W(a), _WW_LOG_W(b), \
+                              _WW_LOG_W(c)), a, b, c)
+#define _WW_LOG_ENCODE_CALL_4(level, a, b, c, d) \
+    _WW_LOG_ENCODE_TYPED(level, \
+        ww_log_encode_output4(_WW_LOG_ENCODE_HDR(level, 4), _WW_LOG_W(a), _WW_LOG_W(b), \
+                              _WW_LOG_W(c), _WW_LOG_W(d)), a, b, c, d)
+
+#define _WW_LOG_ENCODE_CALL_N(level, ...) \
+    _WW_LOG_ENCODE_TYPED(level, \
+        ww_log_encode_output(CURRENT_MODULE_ID, CURRENT_FILE_ID, __LINE__, level, \
+                             _WW_LOG_ARG_COUNT(__VA_ARGS__), __VA_ARGS__), __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_5(level, ...)   _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_6(level, ...)   _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_7(level, ...)   _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_8(level, ...)   _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_9(level, ...)   _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_10(level, ...)  _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_11(level, ...)  _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_12(level, ...)  _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_13(level, ...)  _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_14(level, ...)  _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_15(level, ...)  _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
+#define _WW_LOG_ENCODE_CALL_16(level, ...)  _WW_LOG_ENCODE_CALL_N(level, __VA_ARGS__)
 
 /**
  * Static module switch check with compile-time level filtering
@@ -167,7 +705,8 @@ void ww_log_encode_output(U8 module_id, U16 log_id, U16 line, U8 level,
 
 /* Main expansion macro that checks static switch and conditionally expands */
 #define _WW_LOG_STATIC_EXPAND(level, fmt, ...) \
-    _WW_LOG_IF(CURRENT_MODULE_STATIC_EN)(_WW_LOG_ENCODE_CALL(level, fmt, ##__VA_ARGS__))
+    _WW_LOG_IF(CURRENT_MODULE_STATIC_EN)(_WW_LOG_PREFILTER(level, \
+        _WW_LOG_SITE_GUARD(level, _WW_LOG_ENCODE_CALL(level, fmt, ##__VA_ARGS__))))
 
 #if (WW_LOG_COMPILE_THRESHOLD >= WW_LOG_LEVEL_ERR)
     #define LOG_ERR(fmt, ...) \
@@ -197,29 +736,160 @@ void ww_log_encode_output(U8 module_id, U16 log_id, U16 line, U8 level,
     #define LOG_DBG(fmt, ...)  /* Compiled out by level threshold */
 #endif
 
-/* ========== RAM Buffer (Optional) ========== */
+/**
+ * LOG_HEX(level, data, len) - hex dump of a byte buffer
+ * @param level WW_LOG_LEVEL_xxx (compile-time constant)
+ * @param data Pointer to the bytes
+ * @param len Number of bytes
+ *
+ * Usage:
+ *   LOG_HEX(WW_LOG_LEVEL_DBG, frame, frame_len);
+ */
+#define LOG_HEX(level, data, len) \
+    _WW_LOG_IF(CURRENT_MODULE_STATIC_EN)(_WW_LOG_PREFILTER(level, \
+        _WW_LOG_SITE_GUARD(level, (((level) <= WW_LOG_COMPILE_THRESHOLD) ? \
+            ww_log_encode_hex(_WW_LOG_ENCODE_HDR(level, 0), (data), (len)) : (void)0))))
 
-#ifdef WW_LOG_ENCODE_RAM_BUFFER_EN
+/**
+ * Suppression report of a rate-limited call site (see ww_log_ratelimit.h)
+ */
+#define _WW_LOG_RL_REPORT(level, rl) \
+    ww_log_encode_suppressed(_WW_LOG_ENCODE_HDR(level, 0), &(rl)->suppressed)
 
-#ifndef WW_LOG_RAM_BUFFER_SIZE
-#define WW_LOG_RAM_BUFFER_SIZE  128
+/* ========== Batched Records ========== */
+
+/**
+ * Related records logged in a row can be collected in a batch on the
+ * stack and written together:
+ *
+ *   LOG_BATCH_BEGIN(boot, WW_LOG_LEVEL_INF);
+ *   LOG_BATCH_ADD(boot, "stage %d", stage);
+ *   LOG_BATCH_ADD(boot, "image at %p, %u bytes", addr, size);
+ *   LOG_BATCH_COMMIT(boot);
+ *
+ * - The module and level switches are checked once by LOG_BATCH_BEGIN();
+ *   LOG_BATCH_ADD() of a filtered batch is a test of batch.enabled
+ * - Every record keeps its own line, parameters and timestamp, encoded
+ *   exactly as by LOG_XXX() at the batch level
+ * - LOG_BATCH_COMMIT() reserves the whole batch with one claim on the RAM
+ *   ring and publishes the first header last, so a reader sees either
+ *   none or all of the records (direct output: one sink write)
+ * - Records that do not fit in WW_LOG_BATCH_WORDS are left out, and the
+ *   batch ends with a WW_LOG_CTRL_DROP record counting them; a batch the
+ *   ring has no room for is dropped as a whole
+ * In overwrite mode (WW_LOG_RAM_OVERWRITE_EN) eviction still works per
+ * record, so the oldest batch in the ring can lose its first records.
+ */
+#ifndef WW_LOG_BATCH_WORDS
+#define WW_LOG_BATCH_WORDS  64  /* Record words per batch (header words included) */
 #endif
 
+#define WW_LOG_BATCH_DROP_WORDS  (WW_LOG_HDR_WORDS + 1)  /* Trailing drop record */
+
 typedef struct {
-    U32 magic;
-    U16 head;
-    U16 tail;
-    U32 entries[WW_LOG_RAM_BUFFER_SIZE];
-} WW_LOG_RAM_BUFFER_T;
+    U32 words[WW_LOG_BATCH_WORDS + WW_LOG_BATCH_DROP_WORDS];
+    U32 used;       /* Words filled */
+    U16 records;    /* Records in the batch */
+    U16 dropped;    /* Records that did not fit */
+    U8 enabled;     /* Filter result of LOG_BATCH_BEGIN() */
+    U8 level;       /* Level of the batch */
+} WW_LOG_BATCH_T;
 
-#define WW_LOG_RAM_MAGIC  0x574C4F47
+/**
+ * @brief Start a batch and check the filter for it
+ * @param batch Batch (caller storage, usually on the stack)
+ * @param header WW_LOG_ENCODE(log_id, line, 0, level) of the batch
+ */
+void ww_log_encode_batch_begin(WW_LOG_BATCH_T *batch, WW_LOG_HDR_T header);
 
-extern WW_LOG_RAM_BUFFER_T g_ww_log_ram_buffer;
+/**
+ * @brief Add a record of plain 32-bit parameters to a batch
+ * @param batch Enabled batch
+ * @param header WW_LOG_ENCODE(log_id, line, param_count, level)
+ * @param ... Parameters (each as U32)
+ */
+void ww_log_encode_batch_add(WW_LOG_BATCH_T *batch, WW_LOG_HDR_T header, ...);
 
-U16 ww_log_ram_get_count(void);
-void ww_log_ram_dump(void);
-void ww_log_ram_clear(void);
+/**
+ * @brief Add a typed record to a batch (see ww_log_encode_output_ext())
+ */
+void ww_log_encode_batch_add_ext(WW_LOG_BATCH_T *batch, WW_LOG_HDR_T header, U64 tags, ...);
 
-#endif /* WW_LOG_ENCODE_RAM_BUFFER_EN */
+/**
+ * @brief Write all records of a batch
+ */
+void ww_log_encode_batch_commit(WW_LOG_BATCH_T *batch);
+
+/* Level of a batch, a compile-time constant declared by LOG_BATCH_BEGIN() */
+#define _WW_LOG_BATCH_LEVEL(batch)  _ww_log_batch_level_##batch
+
+#define _WW_LOG_BATCH_ON(batch) \
+    (_WW_LOG_BATCH_LEVEL(batch) <= WW_LOG_COMPILE_THRESHOLD)
+
+#define _WW_LOG_BATCH_CALL(batch, level, ...) \
+    _WW_LOG_CAT(_WW_LOG_BATCH_CALL_, _WW_LOG_ARG_COUNT(__VA_ARGS__))(batch, level, ##__VA_ARGS__)
+
+#define _WW_LOG_BATCH_CALL_0(batch, level) \
+    ww_log_encode_batch_add(&(batch), _WW_LOG_ENCODE_HDR(level, 0))
+
+#define _WW_LOG_BATCH_CALL_N(batch, level, ...) \
+    __builtin_choose_expr(_WW_LOG_TAGS(__VA_ARGS__) == 0, \
+        ww_log_encode_batch_add(&(batch), \
+            _WW_LOG_ENCODE_HDR(level, _WW_LOG_ARG_COUNT(__VA_ARGS__)), __VA_ARGS__), \
+        ww_log_encode_batch_add_ext(&(batch), \
+            _WW_LOG_ENCODE_HDR(level, _WW_LOG_ARG_COUNT(__VA_ARGS__)), \
+            _WW_LOG_TAGS(__VA_ARGS__), _WW_LOG_EXT_ARGS(__VA_ARGS__)))
+#define _WW_LOG_BATCH_CALL_1(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_2(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_3(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_4(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_5(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_6(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_7(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_8(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_9(batch, level, ...)   _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_10(batch, level, ...)  _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_11(batch, level, ...)  _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_12(batch, level, ...)  _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_13(batch, level, ...)  _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_14(batch, level, ...)  _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_15(batch, level, ...)  _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+#define _WW_LOG_BATCH_CALL_16(batch, level, ...)  _WW_LOG_BATCH_CALL_N(batch, level, __VA_ARGS__)
+
+/**
+ * LOG_BATCH_BEGIN(batch, level) - declare a batch and check the filter
+ * LOG_BATCH_ADD(batch, fmt, ...) - add a record (fmt ignored, as LOG_XXX())
+ * LOG_BATCH_COMMIT(batch)        - write the batch
+ *
+ * 'batch' is a plain identifier, 'level' a WW_LOG_LEVEL_xxx constant.
+ * Statically disabled modules and levels above WW_LOG_COMPILE_THRESHOLD
+ * compile to nothing, as LOG_XXX() does.
+ */
+#define LOG_BATCH_BEGIN(batch, level) \
+    _WW_LOG_IF(CURRENT_MODULE_STATIC_EN)( \
+        WW_LOG_BATCH_T batch; \
+        enum { _WW_LOG_BATCH_LEVEL(batch) = (level) }; \
+        if (_WW_LOG_BATCH_ON(batch)) { \
+            ww_log_encode_batch_begin(&(batch), _WW_LOG_ENCODE_HDR(level, 0)); \
+        })
+
+#define LOG_BATCH_ADD(batch, fmt, ...) \
+    _WW_LOG_IF(CURRENT_MODULE_STATIC_EN)( \
+        ((_WW_LOG_BATCH_ON(batch) && (batch).enabled) ? \
+            _WW_LOG_BATCH_CALL(batch, _WW_LOG_BATCH_LEVEL(batch), ##__VA_ARGS__) : (void)0))
+
+#define LOG_BATCH_COMMIT(batch) \
+    _WW_LOG_IF(CURRENT_MODULE_STATIC_EN)( \
+        ((_WW_LOG_BATCH_ON(batch) && (batch).enabled) ? \
+            ww_log_encode_batch_commit(&(batch)) : (void)0))
+
+/* ========== RAM Buffer (Optional) ========== */
+
+/**
+ * With WW_LOG_ENCODE_RAM_BUFFER_EN, ww_log_encode_output() writes records
+ * into the lock-free RAM ring (ww_log_ram.h, included by ww_log.h) instead
+ * of printing them. Read them back with ww_log_ram_read() or
+ * ww_log_ram_dump(). With WW_LOG_ASYNC_EN the drain thread owns the ring.
+ */
 
 #endif /* WW_LOG_ENCODE_H */
@@ -4,16 +4,24 @@
  * @date 2025-12-01
  *
  * This file provides:
- * - Dynamic module mask for runtime filtering (32-bit, one bit per module)
+ * - Dynamic module bitmap for runtime filtering (one bit per module,
+ *   WW_LOG_MODULE_MAX modules)
  * - APIs to control which modules are enabled at runtime
- * - Level threshold control for runtime log filtering
+ * - Level threshold control for runtime log filtering (global, per module,
+ *   per file)
+ * - Combined level table for the O(1) filter and the call site pre-filter
+ * - Sink selection (which registered sinks receive output)
+ *
+ * All of it lives in one configuration snapshot (WW_LOG_CONFIG_T) that is
+ * published by a pointer swap: readers pay one relaxed load, updates are
+ * serialized and become visible all at once.
  *
  * Module configuration is centralized in log_config.json:
  * - Module IDs and names are auto-generated in auto_file_ids.h
  * - Static compile-time switches are auto-generated in auto_file_ids.h
  * - File IDs are auto-generated in auto_file_ids.h
  *
- * File ID Assignment (64 files per module):
+ * File ID Assignment (WW_LOG_FILES_PER_MODULE, default 64 files per module):
  *   - File ID = base_id + offset, where base_id = module_id * 64
  *   - Module 0 (DEFAULT): File IDs 0-63
  *   - Module 1 (DEMO):    File IDs 64-127
@@ -23,10 +31,10 @@
  *   - Module 5 (BROM):    File IDs 320-383
  *
  * Dynamic Switch Usage:
- *   - Each bit in g_ww_log_module_mask controls one module
- *   - Bit 0 = Module 0, Bit 1 = Module 1, etc.
- *   - 0xFFFFFFFF = All modules enabled
- *   - 0x00000000 = All modules disabled
+ *   - Each bit of the module bitmap controls one module
+ *   - Bit n % 32 of word n / 32 = Module n
+ *   - ww_log_set_module_mask() sets modules 0-31 (0xFFFFFFFF = all enabled),
+ *     ww_log_enable_module() / ww_log_disable_module() any module
  *
  * Examples:
  *   // Enable all modules
@@ -45,27 +53,101 @@
 #include "type.h"
 #include "auto_file_ids.h"  /* Auto-generated module IDs and static switches */
 
-/* ========== Dynamic Module Mask ========== */
+/* ========== Configuration Snapshot ========== */
+
+/* Files per module; log_config.json "files_per_module" (auto_file_ids.h) */
+#ifndef WW_LOG_FILES_PER_MODULE
+#define WW_LOG_FILES_PER_MODULE  64  /* File ID = module_id * 64 + offset */
+#endif
+
+#define WW_LOG_FILE_ID_MAX       (WW_LOG_MODULE_MAX * WW_LOG_FILES_PER_MODULE)
+#define WW_LOG_MODULE_WORDS      ((WW_LOG_MODULE_MAX + 31) / 32)
+
+/**
+ * Module n in a module bitmap (O(1): one word load and a shift)
+ */
+#define WW_LOG_MODULE_BIT(map, module_id) \
+    (((map)[(module_id) >> 5] >> ((module_id) & 31)) & 1U)
+
+#ifndef WW_LOG_CONFIG_SLOTS
+#define WW_LOG_CONFIG_SLOTS  4  /* Snapshots in rotation (see ww_log_config_commit) */
+#endif
+
+/**
+ * Runtime configuration (one immutable snapshot once published)
+ */
+typedef struct {
+    U32 seq;                              /* Slot sequence: odd while the slot is rewritten */
+    U32 version;                          /* Incremented by every commit */
+    U32 module_mask[WW_LOG_MODULE_WORDS]; /* Module bitmap, see WW_LOG_MODULE_BIT() */
+    U32 sink_mask;                        /* Bit n = sink slot n enabled */
+    U8 level_threshold;                   /* Global threshold (last set for all modules) */
+    U8 module_level[WW_LOG_MODULE_MAX];   /* Threshold per module */
+    U8 file_level[WW_LOG_FILE_ID_MAX];    /* Per-file override: 0 = none, else threshold + 1 */
+    U8 level_table[WW_LOG_FILE_ID_MAX];   /* Derived filter, built by the commit */
+} WW_LOG_CONFIG_T;
+
+/**
+ * Current snapshot - read with ww_log_config_current()
+ */
+extern WW_LOG_CONFIG_T *g_ww_log_config;
+
+/**
+ * @brief Get the current configuration snapshot (hot path)
+ * @return Snapshot to read single fields from
+ *
+ * One relaxed load. Reads through the returned pointer depend on its
+ * value, which orders them after the load on every supported CPU (the
+ * rcu_dereference() argument), so no barrier is needed.
+ *
+ * Snapshots rotate through WW_LOG_CONFIG_SLOTS slots. A reader that
+ * stalls between this load and its field read while that many updates
+ * are committed reads the field from a newer configuration - fine for
+ * a single field (level_table entry, sink_mask), which is how the log
+ * paths use it. Use ww_log_config_read() to inspect several fields.
+ */
+static inline const WW_LOG_CONFIG_T *ww_log_config_current(void)
+{
+    return __atomic_load_n(&g_ww_log_config, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Copy a consistent configuration snapshot
+ * @param out Destination
+ *
+ * Lock-free; retries while the slot being copied is rewritten.
+ */
+void ww_log_config_read(WW_LOG_CONFIG_T *out);
 
 /**
- * Global module mask variable
- * Each bit controls whether a module is enabled at runtime
- * Default: 0xFFFFFFFF (all modules enabled)
+ * @brief Start a configuration update
+ * @return Private copy of the current configuration to modify
+ *
+ * Takes the configuration lock; every begin must be followed by
+ * ww_log_config_commit(). Change any fields except seq, version and
+ * level_table, e.g. several thresholds at once:
+ *
+ *   WW_LOG_CONFIG_T *cfg = ww_log_config_begin();
+ *   memset(cfg->module_level, WW_LOG_LEVEL_WRN, sizeof(cfg->module_level));
+ *   cfg->module_level[WW_LOG_MODULE_DRIVERS] = WW_LOG_LEVEL_DBG;
+ *   ww_log_config_commit(cfg);
  */
-extern U32 g_ww_log_module_mask;
+WW_LOG_CONFIG_T *ww_log_config_begin(void);
 
 /**
- * @brief Check if a module is enabled (runtime check)
- * @param module_id Module ID (0-31)
- * @return Non-zero if enabled, 0 if disabled
- * #define WW_LOG_MODULE_ENABLED(module_id) \
- *    ((g_ww_log_module_mask & (1U << (module_id))) != 0)
-*/
+ * @brief Publish a configuration update
+ * @param cfg Copy returned by ww_log_config_begin()
+ *
+ * Rebuilds level_table, then publishes the copy with one pointer store:
+ * a reader sees either the old or the new configuration, never a mix.
+ */
+void ww_log_config_commit(WW_LOG_CONFIG_T *cfg);
+
 /* ========== API Functions ========== */
 
 /**
  * @brief Set module mask to control which modules are enabled
- * @param mask 32-bit mask, each bit controls one module
+ * @param mask 32-bit mask for modules 0-31 (higher modules keep their bits)
  *
  * Examples:
  *   ww_log_set_module_mask(0xFFFFFFFF);  // Enable all
@@ -76,42 +158,38 @@ void ww_log_set_module_mask(U32 mask);
 
 /**
  * @brief Get current module mask
- * @return Current 32-bit module mask
+ * @return Bits of modules 0-31
  */
 U32 ww_log_get_module_mask(void);
 
 /**
  * @brief Enable a specific module
- * @param module_id Module ID (0-31)
+ * @param module_id Module ID (0 .. WW_LOG_MODULE_MAX - 1)
  */
-void ww_log_enable_module(U8 module_id);
+void ww_log_enable_module(U16 module_id);
 
 /**
  * @brief Disable a specific module
- * @param module_id Module ID (0-31)
+ * @param module_id Module ID (0 .. WW_LOG_MODULE_MAX - 1)
  */
-void ww_log_disable_module(U8 module_id);
+void ww_log_disable_module(U16 module_id);
 
 /**
  * @brief Check if a specific module is enabled
- * @param module_id Module ID (0-31)
+ * @param module_id Module ID (0 .. WW_LOG_MODULE_MAX - 1)
  * @return 1 if enabled, 0 if disabled
  */
-U8 ww_log_is_module_enabled(U8 module_id);
+U8 ww_log_is_module_enabled(U16 module_id);
 
 /* ========== Level Threshold Control ========== */
 
-/**
- * Global log level threshold (runtime configurable)
- * Logs with level > threshold will be filtered out
- * Default: WW_LOG_LEVEL_DBG (allow all)
- */
-extern U8 g_ww_log_level_threshold;
-
 /**
  * @brief Set global log level threshold
  * @param level New threshold (WW_LOG_LEVEL_ERR/WRN/INF/DBG)
  *
+ * Sets the threshold of every module; per-file overrides are kept.
+ * Set the global threshold first, then raise or lower single modules.
+ *
  * Examples:
  *   ww_log_set_level_threshold(WW_LOG_LEVEL_ERR);  // Only errors
  *   ww_log_set_level_threshold(WW_LOG_LEVEL_WRN);  // Errors + warnings
@@ -125,4 +203,102 @@ void ww_log_set_level_threshold(U8 level);
  */
 U8 ww_log_get_level_threshold(void);
 
+/**
+ * @brief Set the level threshold of one module
+ * @param module_id Module ID (0 .. WW_LOG_MODULE_MAX - 1)
+ * @param level New threshold (WW_LOG_LEVEL_ERR/WRN/INF/DBG)
+ *
+ * Example (DRIVERS at DBG, everything else at WRN):
+ *   ww_log_set_level_threshold(WW_LOG_LEVEL_WRN);
+ *   ww_log_set_module_level(WW_LOG_MODULE_DRIVERS, WW_LOG_LEVEL_DBG);
+ */
+void ww_log_set_module_level(U16 module_id, U8 level);
+
+/**
+ * @brief Get the level threshold of one module
+ * @param module_id Module ID (0 .. WW_LOG_MODULE_MAX - 1)
+ * @return Current threshold of the module
+ */
+U8 ww_log_get_module_level(U16 module_id);
+
+/**
+ * @brief Override the level threshold of one file
+ * @param file_id File ID (FILE_ID_XXX from auto_file_ids.h)
+ * @param level New threshold (WW_LOG_LEVEL_ERR/WRN/INF/DBG)
+ *
+ * The override wins over the threshold of the file's module until
+ * ww_log_clear_file_level(); the module mask still applies.
+ */
+void ww_log_set_file_level(U16 file_id, U8 level);
+
+/**
+ * @brief Remove the level override of one file
+ * @param file_id File ID
+ */
+void ww_log_clear_file_level(U16 file_id);
+
+/**
+ * @brief Get the level threshold in effect for one file
+ * @param file_id File ID
+ * @return File override if set, otherwise the module threshold
+ */
+U8 ww_log_get_file_level(U16 file_id);
+
+/* ========== Sink Selection ========== */
+
+/**
+ * @brief Select the registered sinks that receive output
+ * @param mask Bit n = sink slot n (default: all; see ww_log_sink_add())
+ */
+void ww_log_set_sink_mask(U32 mask);
+
+/**
+ * @brief Get the sink selection
+ * @return Current sink mask
+ */
+U32 ww_log_get_sink_mask(void);
+
+/* ========== Combined Level Table ========== */
+
+/*
+ * level_table holds the number of levels that pass the dynamic switches,
+ * per file ID: 0 = module disabled, otherwise the file's threshold + 1.
+ * The filter is one byte load and compare: level < level_table[file_id].
+ */
+
+/**
+ * @brief Check the dynamic switches for a record (used by the output functions)
+ * @param file_id File ID of the call site
+ * @param level Log level
+ * @return Non-zero if the record should be written
+ */
+static inline U8 ww_log_level_enabled(U16 file_id, U8 level)
+{
+    return (file_id < WW_LOG_FILE_ID_MAX) &&
+           (level < ww_log_config_current()->level_table[file_id]);
+}
+
+/**
+ * Inline pre-filter of a call site (optional, -DWW_LOG_PREFILTER_EN)
+ *
+ * With a constant file ID and level the check is the snapshot load, one
+ * byte load and a compare in front of the call, so a record rejected at
+ * runtime neither evaluates its arguments nor calls the output function.
+ * It costs those loads and the compare (about 25 bytes on x86-64) per
+ * call site; without the flag the output functions do the same filtering
+ * after the call.
+ */
+#define _WW_LOG_LEVEL_PASS(file_id, level) \
+    ((level) < ww_log_config_current()->level_table[file_id])
+
+#ifdef WW_LOG_PREFILTER_EN
+#define _WW_LOG_PREFILTER(level, call) do { \
+    if (_WW_LOG_LEVEL_PASS(CURRENT_FILE_ID, level)) { \
+        call; \
+    } \
+} while (0)
+#else
+#define _WW_LOG_PREFILTER(level, call)  call
+#endif
+
 #endif /* WW_LOG_MODULES_H */
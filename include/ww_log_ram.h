@@ -0,0 +1,284 @@
+/**
+ * @file ww_log_ram.h
+ * @brief Lock-free multi-producer RAM ring buffer for log records
+ * @date 2026-10-16
+ *
+ * The ring stores whole log records as runs of U32 words:
+ *   [HEADER][PARAM 0]...[PARAM N-1]
+ * The record length is taken from the DATA_LEN field of the header
+ * (same layout as WW_LOG_ENCODE), so the ring never needs its own framing.
+ *
+ * Concurrency model (MPSC, lock-free):
+ * - Producers reserve 1 + param_count words with a single CAS on 'tail',
+ *   fill the parameter slots, then publish the record by storing its
+ *   header word last (release store). Producers never wait for each other.
+ * - An unpublished slot reads as 0 (no valid header is 0: LINE is never
+ *   0 in v1 headers, DATA_LEN never 0 in v2 headers). A single consumer reads records from 'head' while the header
+ *   slot is non-zero, zeroes the consumed slots and advances 'head'.
+ * - When the ring is full the new record is dropped (drop-newest). Drops
+ *   are counted; the next record that fits is preceded by a drop marker
+ *   record (WW_LOG_RAM_DROP_HDR, last word = records dropped), so the output shows
+ *   where records went missing. ww_log_ram_get_stats() returns the totals.
+ *   With WW_LOG_ASYNC_BLOCK_EN the producer waits for the drain thread
+ *   instead (see ww_log_async_wait()).
+ *
+ * Flight-recorder mode (WW_LOG_RAM_OVERWRITE_EN, overwrite-oldest):
+ * - A producer that does not fit evicts whole records from 'head' until it
+ *   does, so 'head' always stays on a record boundary. Reservation and
+ *   eviction are serialized by a short lock (no copying inside it); the
+ *   parameter copy and the publish are still done outside it.
+ * - The producer zeroes its own header slot before moving 'tail', since
+ *   evicted slots are not cleared by a consumer.
+ * - If the oldest record is still being written it cannot be evicted;
+ *   the new record is dropped instead (counted as above).
+ * - Readers never block producers: ww_log_ram_read() and
+ *   ww_log_ram_clear() advance 'head' per record with a CAS and discard a
+ *   record that was evicted while it was copied; ww_log_ram_snapshot()
+ *   copies the live window without consuming it.
+ *
+ * Persistent ring (WW_LOG_RAM_PERSIST_EN):
+ * - ww_log_init() maps the ring from a file (MAP_SHARED), standing in for
+ *   no-init RAM: everything written survives a crash of the process.
+ *   Producers still only do loads and stores (one extra pointer load).
+ * - On start the layout fields (magic, version, size) and the positions
+ *   are checked: 'tail - head' must fit the ring and the records from
+ *   'head' must end on 'tail' or at an unpublished header. Those records
+ *   are copied out as the previous run (ww_log_ram_prev_get/_save) and
+ *   the ring is reset for the new run.
+ *
+ * All positions are free-running U32 word counters; the slot index is
+ * (position & (WW_LOG_RAM_BUFFER_SIZE - 1)), so the size must be a power of 2.
+ */
+
+#ifndef WW_LOG_RAM_H
+#define WW_LOG_RAM_H
+
+#include "type.h"
+
+/*
+ * Ring size in U32 words (power of 2). As a RAM dump 128 words are enough;
+ * in async mode every record passes through the ring on its way to the
+ * sinks, so it has to absorb bursts while the drain thread catches up.
+ */
+#ifndef WW_LOG_RAM_BUFFER_SIZE
+#ifdef WW_LOG_ASYNC_EN
+#define WW_LOG_RAM_BUFFER_SIZE  16384  /* 64 KB output queue */
+#else
+#define WW_LOG_RAM_BUFFER_SIZE  128
+#endif
+#endif
+
+/* Overwrite-oldest instead of drop-newest (optional) */
+// #define WW_LOG_RAM_OVERWRITE_EN
+
+#if (WW_LOG_RAM_BUFFER_SIZE & (WW_LOG_RAM_BUFFER_SIZE - 1)) != 0
+#error "WW_LOG_RAM_BUFFER_SIZE must be a power of 2"
+#endif
+
+#define WW_LOG_RAM_MAGIC  0x574C4F47  /* "WLOG" */
+#define WW_LOG_RAM_LAYOUT_VERSION  2   /* Bump when WW_LOG_RAM_BUFFER_T changes */
+
+/* Ring file for WW_LOG_RAM_PERSIST_EN (see ww_log_ram_persist_set_path()) */
+#ifndef WW_LOG_RAM_PERSIST_PATH
+#define WW_LOG_RAM_PERSIST_PATH  "ww_log_ring.bin"
+#endif
+
+/* Keep consumer and producer positions on separate cache lines */
+#define WW_LOG_RAM_CACHELINE  64
+
+/**
+ * Number of ring words occupied by the record starting with header 'hdr'
+ */
+#define WW_LOG_RAM_REC_WORDS(hdr)  (1U + (((U32)(hdr) >> 2) & 0x3F))
+
+/**
+ * Drop marker record (encode layout: control record WW_LOG_CTRL_DROP,
+ * level WRN) whose last word holds the number of records dropped since
+ * the previous marker:
+ * - v1 header and string mode: [0xFFF00305][dropped]
+ *   (LOG_ID 0xFFF, LINE 3, DATA_LEN 1)
+ * - v2 header: [0xFFFF0009][3][dropped] (LOG_ID 0xFFFF, DATA_LEN 2, LINE word 3)
+ */
+#if defined(WW_LOG_MODE_ENCODE) && !defined(WW_LOG_ENCODE_V1)
+#define WW_LOG_RAM_DROP_HDR    0xFFFF0009U
+#define WW_LOG_RAM_DROP_WORDS  3
+#else
+#define WW_LOG_RAM_DROP_HDR    0xFFF00305U
+#define WW_LOG_RAM_DROP_WORDS  2
+#endif
+
+/**
+ * Ring slot for a free-running word position
+ */
+#define WW_LOG_RAM_SLOT(pos) \
+    (g_ww_log_ram_buffer.entries[(pos) & (WW_LOG_RAM_BUFFER_SIZE - 1)])
+
+typedef struct {
+    U32 magic;
+    U32 version;    /* WW_LOG_RAM_LAYOUT_VERSION */
+    U32 size;       /* WW_LOG_RAM_BUFFER_SIZE */
+    U32 head;       /* Consumer position: first unread word */
+    U32 records_out;/* Records consumed so far (free-running) */
+    U32 tail __attribute__((aligned(WW_LOG_RAM_CACHELINE)));
+                    /* Producer position: next word to be reserved */
+    U32 records_in; /* Records reserved so far (free-running) */
+    U32 words_in;   /* Words reserved so far (free-running) */
+    U32 dropped;    /* Records dropped because the ring was full */
+    U32 drops_pending; /* Drops not yet reported by a marker */
+    U32 high_water; /* Highest fill level seen, in words */
+    U32 overwritten;/* Records evicted by WW_LOG_RAM_OVERWRITE_EN */
+    U32 entries[WW_LOG_RAM_BUFFER_SIZE] __attribute__((aligned(WW_LOG_RAM_CACHELINE)));
+} WW_LOG_RAM_BUFFER_T;
+
+#ifdef WW_LOG_RAM_PERSIST_EN
+extern WW_LOG_RAM_BUFFER_T g_ww_log_ram_boot;  /* Used until the file is mapped */
+extern WW_LOG_RAM_BUFFER_T *g_ww_log_ram_map;
+#define g_ww_log_ram_buffer  (*g_ww_log_ram_map)
+#else
+extern WW_LOG_RAM_BUFFER_T g_ww_log_ram_buffer;
+#endif
+
+/**
+ * Ring statistics (counters are free-running)
+ */
+typedef struct {
+    U32 records;    /* Records written, drop markers included */
+    U32 dropped;    /* Records dropped because the ring was full */
+    U64 bytes;      /* Bytes written (wraps with the 32-bit word counter) */
+    U32 high_water; /* Highest fill level seen, in words */
+    U32 overwritten;/* Records evicted to make room (overwrite mode) */
+    U32 size;       /* Ring size in words */
+} WW_LOG_RAM_STATS_T;
+
+/* ========== Producer API (any thread) ========== */
+
+/**
+ * @brief Reserve space for one record
+ * @param words Record size in words (1 + param_count)
+ * @param pos Output: start position of the reservation
+ * @return 0 on success, -1 if the ring is full (record must be dropped)
+ *
+ * A failed reservation counts as a dropped record. When earlier drops are
+ * still unreported, a drop marker is written in front of the record.
+ * On success the caller MUST fill the parameter slots
+ * WW_LOG_RAM_SLOT(pos + 1 .. pos + words - 1) and then call
+ * ww_log_ram_commit(pos, header) with a header whose DATA_LEN matches.
+ */
+S8 ww_log_ram_reserve(U32 words, U32 *pos);
+
+/**
+ * @brief Reserve space for several records at once
+ * @param words Total size of the records in words
+ * @param records Number of records
+ * @param pos Output: start position of the reservation
+ * @return 0 on success, -1 if the ring is full (all records are dropped)
+ *
+ * One claim for the whole run of records. The caller fills every slot
+ * except the header of the first record, then publishes the run with
+ * ww_log_ram_commit(pos, first header): the consumer stops at the first
+ * unpublished header, so it sees either none or all of the records.
+ */
+S8 ww_log_ram_reserve_batch(U32 words, U32 records, U32 *pos);
+
+/**
+ * @brief Publish a reserved record to the consumer
+ * @param pos Start position returned by ww_log_ram_reserve()
+ * @param header Record header (written last, makes the record visible)
+ */
+static inline void ww_log_ram_commit(U32 pos, U32 header)
+{
+    __atomic_store_n(&WW_LOG_RAM_SLOT(pos), header, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy a complete record into the ring (reserve + copy + commit)
+ * @param words Record words (header first)
+ * @param count Number of words
+ * @return 0 on success, -1 if the ring is full
+ */
+S8 ww_log_ram_write(const U32 *words, U32 count);
+
+/* ========== Consumer API (single thread) ========== */
+
+/**
+ * @brief Move complete records out of the ring
+ * @param out Destination buffer
+ * @param max_words Capacity of 'out' in words
+ * @return Number of words copied (always a whole number of records)
+ */
+U32 ww_log_ram_read(U32 *out, U32 max_words);
+
+/**
+ * @brief Copy the published records without consuming them
+ * @param out Destination buffer
+ * @param max_words Capacity of 'out' in words (WW_LOG_RAM_BUFFER_SIZE
+ *                  holds the whole window; otherwise the oldest records
+ *                  that fit are returned)
+ * @return Number of words copied (always a whole number of records)
+ *
+ * One pass over the window: the words are copied, then 'head' is read
+ * again and every record that was evicted meanwhile is discarded. Safe
+ * against concurrent producers in both modes; in drop-newest mode do not
+ * run it concurrently with ww_log_ram_read() (the consumer).
+ */
+U32 ww_log_ram_snapshot(U32 *out, U32 max_words);
+
+/**
+ * @brief Get number of words reserved in the ring (published or in flight)
+ */
+U32 ww_log_ram_get_count(void);
+
+/**
+ * @brief Discard all published records (consumer side)
+ */
+void ww_log_ram_clear(void);
+
+/**
+ * @brief Read the ring statistics (any thread)
+ * @param stats Output
+ */
+void ww_log_ram_get_stats(WW_LOG_RAM_STATS_T *stats);
+
+/**
+ * @brief Dump all entries in the ring to stdout (mode specific decoding)
+ */
+void ww_log_ram_dump(void);
+
+/* ========== Persistent Ring (Optional) ========== */
+
+#ifdef WW_LOG_RAM_PERSIST_EN
+
+/**
+ * @brief Select the ring file (call before ww_log_init())
+ * @param path File path (storage must stay valid)
+ */
+void ww_log_ram_persist_set_path(const char *path);
+
+/**
+ * @brief Map the ring file, recover the previous run and switch the ring
+ *        over to the file (called by ww_log_init())
+ * @return 1 if a previous run was recovered, 0 if the file was new or
+ *         invalid, -1 if the file could not be mapped (the ring stays in RAM)
+ */
+S8 ww_log_ram_persist_open(void);
+
+/**
+ * @brief Records recovered from the previous run
+ * @param words Output: number of words (whole records)
+ * @return Record words, header first (valid until the next open)
+ */
+const U32 *ww_log_ram_prev_get(U32 *words);
+
+/**
+ * @brief Write the previous run's records to a file
+ * @param path Output file
+ * @return 0 on success, -1 on error
+ *
+ * Encode mode: a binary stream (stream header + records) for
+ * tools/log_decoder.py. String mode: the text lines.
+ */
+S8 ww_log_ram_prev_save(const char *path);
+
+#endif /* WW_LOG_RAM_PERSIST_EN */
+
+#endif /* WW_LOG_RAM_H */
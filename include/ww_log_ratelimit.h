@@ -0,0 +1,126 @@
+/**
+ * @file ww_log_ratelimit.h
+ * @brief Per-call-site rate limiting and one-shot logging
+ * @date 2026-10-16
+ *
+ * LOG_XXX_RATELIMIT(fmt, ...) lets a call site pass at most
+ * WW_LOG_RL_BURST records per WW_LOG_RL_INTERVAL_MS (token bucket).
+ * LOG_XXX_ONCE(fmt, ...) lets a call site pass exactly once.
+ *
+ * Each call site owns a static WW_LOG_RL_T. While it has tokens, a call
+ * costs one load and compare plus the token decrement; only an empty
+ * bucket goes to ww_log_rl_refill(), which reads the clock. Records that
+ * do not get a token are counted, and the next record that passes is
+ * preceded by a report of how many were suppressed:
+ * - String mode: "[LVL] file:line - N records suppressed (rate limit)"
+ * - Encode mode: control record WW_LOG_CTRL_SUPPRESS [site header][count]
+ *
+ * The state is updated with relaxed atomics and no lock: concurrent
+ * callers of one site may let a token or two more through, never fewer.
+ * Use the ERR variants for error paths that can repeat - an error storm
+ * then costs the sink (and the async ERR flush) one burst per interval.
+ */
+
+#ifndef WW_LOG_RATELIMIT_H
+#define WW_LOG_RATELIMIT_H
+
+#include "type.h"
+
+/* ========== Configuration ========== */
+
+#ifndef WW_LOG_RL_BURST
+#define WW_LOG_RL_BURST        10    /* Records per interval (bucket size) */
+#endif
+
+#ifndef WW_LOG_RL_INTERVAL_MS
+#define WW_LOG_RL_INTERVAL_MS  1000  /* Time to refill the whole bucket */
+#endif
+
+/* ========== Call Site State ========== */
+
+/**
+ * Rate limit state of one call site
+ */
+typedef struct {
+    S32 tokens;     /* Records that may pass before the next refill */
+    U32 suppressed; /* Records suppressed since the last report */
+    U32 last_ms;    /* Time of the last refill (ms, wraps) */
+} WW_LOG_RL_T;
+
+#define WW_LOG_RL_INIT  { WW_LOG_RL_BURST, 0, 0 }
+
+/* ========== API Functions ========== */
+
+/**
+ * @brief Refill an empty bucket (slow path)
+ * @param rl Call site state
+ * @return 0 = suppress the record, 1 = pass, 2 = pass after reporting
+ *         the suppressed records
+ */
+U8 ww_log_rl_refill(WW_LOG_RL_T *rl);
+
+/**
+ * @brief Token for one record
+ * @return As ww_log_rl_refill()
+ */
+static inline U8 ww_log_rl_take(WW_LOG_RL_T *rl)
+{
+    if (__builtin_expect(__atomic_load_n(&rl->tokens, __ATOMIC_RELAXED) > 0, 1)) {
+        __atomic_fetch_sub(&rl->tokens, 1, __ATOMIC_RELAXED);
+        return 1;
+    }
+    return ww_log_rl_refill(rl);
+}
+
+/* ========== Public API Macros ========== */
+
+/**
+ * Call site switch and suppression report of the active mode
+ * (_WW_LOG_RL_REPORT is defined by ww_log_encode.h / ww_log_str.h)
+ */
+#if defined(WW_LOG_MODE_ENCODE)
+#define _WW_LOG_RL_SITE_IF(cond)  _WW_LOG_IF(cond)
+#else
+#define _WW_LOG_RL_SITE_IF(cond)  _WW_LOG_STR_IF(cond)
+#endif
+
+#define _WW_LOG_RATELIMIT(level, log_call) \
+    _WW_LOG_RL_SITE_IF(CURRENT_MODULE_STATIC_EN)(do { \
+        if ((level) <= WW_LOG_COMPILE_THRESHOLD) { \
+            static WW_LOG_RL_T _ww_log_rl = WW_LOG_RL_INIT; \
+            U8 _ww_log_pass = ww_log_rl_take(&_ww_log_rl); \
+            if (_ww_log_pass != 0) { \
+                if (_ww_log_pass > 1) { \
+                    _WW_LOG_RL_REPORT(level, &_ww_log_rl); \
+                } \
+                log_call; \
+            } \
+        } \
+    } while (0))
+
+#define _WW_LOG_ONCE(level, log_call) \
+    _WW_LOG_RL_SITE_IF(CURRENT_MODULE_STATIC_EN)(do { \
+        if ((level) <= WW_LOG_COMPILE_THRESHOLD) { \
+            static U8 _ww_log_once = 0; \
+            if (__atomic_load_n(&_ww_log_once, __ATOMIC_RELAXED) == 0 && \
+                __atomic_exchange_n(&_ww_log_once, 1, __ATOMIC_RELAXED) == 0) { \
+                log_call; \
+            } \
+        } \
+    } while (0))
+
+#define LOG_ERR_RATELIMIT(fmt, ...) \
+    _WW_LOG_RATELIMIT(WW_LOG_LEVEL_ERR, LOG_ERR(fmt, ##__VA_ARGS__))
+#define LOG_WRN_RATELIMIT(fmt, ...) \
+    _WW_LOG_RATELIMIT(WW_LOG_LEVEL_WRN, LOG_WRN(fmt, ##__VA_ARGS__))
+#define LOG_INF_RATELIMIT(fmt, ...) \
+    _WW_LOG_RATELIMIT(WW_LOG_LEVEL_INF, LOG_INF(fmt, ##__VA_ARGS__))
+#define LOG_DBG_RATELIMIT(fmt, ...) \
+    _WW_LOG_RATELIMIT(WW_LOG_LEVEL_DBG, LOG_DBG(fmt, ##__VA_ARGS__))
+
+#define LOG_ERR_ONCE(fmt, ...)  _WW_LOG_ONCE(WW_LOG_LEVEL_ERR, LOG_ERR(fmt, ##__VA_ARGS__))
+#define LOG_WRN_ONCE(fmt, ...)  _WW_LOG_ONCE(WW_LOG_LEVEL_WRN, LOG_WRN(fmt, ##__VA_ARGS__))
+#define LOG_INF_ONCE(fmt, ...)  _WW_LOG_ONCE(WW_LOG_LEVEL_INF, LOG_INF(fmt, ##__VA_ARGS__))
+#define LOG_DBG_ONCE(fmt, ...)  _WW_LOG_ONCE(WW_LOG_LEVEL_DBG, LOG_DBG(fmt, ##__VA_ARGS__))
+
+#endif /* WW_LOG_RATELIMIT_H */
@@ -0,0 +1,148 @@
+/**
+ * @file ww_log_sink.h
+ * @brief Pluggable output sinks for the logging system
+ * @date 2026-10-16
+ *
+ * All log output (string lines, encode hex text or binary words) is handed
+ * to the registered sinks instead of being written to stdio directly.
+ * Every sink is a small object with an operations table:
+ *
+ *   write   - write one buffer
+ *   writev  - write a batch of buffers (one syscall for fd sinks)
+ *   flush   - push buffered data out
+ *   close   - release the sink (only closes what the sink opened itself)
+ *
+ * Built-in sinks:
+ *   fd     - raw file descriptor (UART stand-in: pty, pipe, socket), no stdio
+ *   file   - stdio FILE* stream; stdout is the default sink
+ *   memory - fixed RAM buffer, data past the end is dropped
+ *   null   - discards everything (benchmarks, muted builds)
+ *
+ * Up to WW_LOG_SINK_MAX sinks can be registered; output fans out to all
+ * of them, or to those selected with ww_log_set_sink_mask() (bit n =
+ * slot n). ww_log_sink_add() takes the lowest free slot and a sink keeps
+ * it until ww_log_sink_remove(), so removing a sink never moves another.
+ * Register sinks before ww_log_init(); if none is registered by then,
+ * ww_log_init() registers a file sink on stdout.
+ *
+ * Example:
+ *   static WW_LOG_SINK_T uart, file;
+ *   ww_log_sink_fd_init(&uart, pty_fd);
+ *   ww_log_sink_file_open(&file, "log.bin");
+ *   ww_log_sink_add(&uart);
+ *   ww_log_sink_add(&file);
+ *   ww_log_init();
+ */
+
+#ifndef WW_LOG_SINK_H
+#define WW_LOG_SINK_H
+
+#include <stdio.h>
+#include <sys/uio.h>
+#include "type.h"
+
+#ifndef WW_LOG_SINK_MAX
+#define WW_LOG_SINK_MAX  4
+#endif
+
+typedef struct ww_log_sink WW_LOG_SINK_T;
+
+/**
+ * Sink operations table
+ */
+typedef struct {
+    S32 (*write)(WW_LOG_SINK_T *sink, const void *buf, U32 len);
+    S32 (*writev)(WW_LOG_SINK_T *sink, const struct iovec *iov, U32 count);
+    void (*flush)(WW_LOG_SINK_T *sink);
+    void (*close)(WW_LOG_SINK_T *sink);
+} WW_LOG_SINK_OPS_T;
+
+/**
+ * Sink instance (storage provided by the caller)
+ */
+struct ww_log_sink {
+    const WW_LOG_SINK_OPS_T *ops;
+    S32 fd;         /* fd sink */
+    FILE *fp;       /* file sink */
+    U8 *mem;        /* memory sink buffer */
+    U32 mem_size;   /* memory sink capacity */
+    U32 mem_used;   /* memory sink fill level */
+    U8 owned;       /* fd/fp was opened by the sink and is closed by close() */
+};
+
+/* ========== Built-in Sinks ========== */
+
+/**
+ * @brief Initialize a sink on an existing file descriptor (not closed by close())
+ */
+void ww_log_sink_fd_init(WW_LOG_SINK_T *sink, S32 fd);
+
+/**
+ * @brief Initialize a sink on an existing stdio stream (not closed by close())
+ */
+void ww_log_sink_file_init(WW_LOG_SINK_T *sink, FILE *fp);
+
+/**
+ * @brief Open (truncate) a file and initialize a file sink that owns it
+ * @return 0 on success, -1 if the file cannot be opened
+ */
+S8 ww_log_sink_file_open(WW_LOG_SINK_T *sink, const char *path);
+
+/**
+ * @brief Initialize a memory sink on a caller-provided buffer
+ */
+void ww_log_sink_mem_init(WW_LOG_SINK_T *sink, void *buf, U32 size);
+
+/**
+ * @brief Initialize a sink that discards all output
+ */
+void ww_log_sink_null_init(WW_LOG_SINK_T *sink);
+
+/* ========== Registration ========== */
+
+/**
+ * @brief Register a sink for output
+ * @return 0 on success, -1 if WW_LOG_SINK_MAX sinks are already registered
+ *
+ * The sink takes the lowest free slot (its sink mask bit).
+ */
+S8 ww_log_sink_add(WW_LOG_SINK_T *sink);
+
+/**
+ * @brief Unregister a sink (does not close it)
+ *
+ * Returns once no write that may still use the sink is in flight, so the
+ * caller can close or reuse it.
+ */
+void ww_log_sink_remove(WW_LOG_SINK_T *sink);
+
+/**
+ * @brief Get number of registered sinks
+ */
+U8 ww_log_sink_count(void);
+
+/* ========== Fan-out (used by the output paths) ========== */
+
+/**
+ * @brief Write one buffer to every selected sink
+ */
+void ww_log_sink_write(const void *buf, U32 len);
+
+/**
+ * @brief Write a batch of buffers to every selected sink
+ */
+void ww_log_sink_writev(const struct iovec *iov, U32 count);
+
+/**
+ * @brief Flush every registered sink
+ */
+void ww_log_sink_flush(void);
+
+/**
+ * @brief Flush, close and unregister every sink
+ *
+ * Waits for writes in flight first; later writes find no sink.
+ */
+void ww_log_sink_close_all(void);
+
+#endif /* WW_LOG_SINK_H */
@@ -0,0 +1,95 @@
+/**
+ * @file ww_log_site.h
+ * @brief Per-call-site runtime enable table (dynamic debug style)
+ * @date 2026-10-16
+ *
+ * Enabled with -DWW_LOG_SITE_CTRL_EN (string and encode mode).
+ *
+ * Every LOG_XXX() expansion places a static WW_LOG_SITE_T descriptor
+ * (file ID, line, level, enabled flag) in the "ww_log_sites" ELF section
+ * and only calls the output function while its flag is set. A disabled
+ * site costs one byte load and a branch; nothing else of the call is
+ * executed. The linker collects all descriptors into one table
+ * (__start_ww_log_sites .. __stop_ww_log_sites), which
+ * ww_log_site_set() walks to switch sites by file, line range and level.
+ *
+ * The per-site flag comes on top of the module mask and the level
+ * threshold: a record is written only if all three let it pass.
+ * DBG sites can stay compiled in on production builds and be switched
+ * off here (or left off and switched on for one file when needed).
+ */
+
+#ifndef WW_LOG_SITE_H
+#define WW_LOG_SITE_H
+
+#include "type.h"
+
+/* ========== Site Descriptor ========== */
+
+/**
+ * Descriptor of one call site (8 bytes, packed back to back in the section)
+ * The line is 32 bits wide, as in the record format.
+ */
+typedef struct {
+    U16 file_id;    /* CURRENT_FILE_ID */
+    U8 level;       /* WW_LOG_LEVEL_xxx */
+    U8 enabled;     /* 0 = call skipped */
+    U32 line;       /* __LINE__ */
+} __attribute__((aligned(8))) WW_LOG_SITE_T;
+
+/**
+ * Site selection for ww_log_site_set(), all ranges inclusive
+ */
+typedef struct {
+    U16 file_id;    /* File ID or WW_LOG_SITE_ANY_FILE */
+    U32 line_min;
+    U32 line_max;
+    U8 level_min;   /* WW_LOG_LEVEL_ERR .. */
+    U8 level_max;   /* .. WW_LOG_LEVEL_DBG */
+} WW_LOG_SITE_QUERY_T;
+
+#define WW_LOG_SITE_ANY_FILE  0xFFFF
+
+/* Every site */
+#define WW_LOG_SITE_QUERY_ALL \
+    { WW_LOG_SITE_ANY_FILE, 0, 0xFFFFFFFFU, WW_LOG_LEVEL_ERR, WW_LOG_LEVEL_DBG }
+
+/* ========== API Functions ========== */
+
+#ifdef WW_LOG_SITE_CTRL_EN
+
+/**
+ * @brief Enable or disable the matching call sites
+ * @param query Sites to change
+ * @param enable 1 = enable, 0 = disable
+ * @return Number of matching sites
+ */
+U32 ww_log_site_set(const WW_LOG_SITE_QUERY_T *query, U8 enable);
+
+/**
+ * @brief Get the call site table
+ * @param count Output: number of descriptors
+ * @return First descriptor (table of the whole program, link order)
+ */
+WW_LOG_SITE_T *ww_log_site_table(U32 *count);
+
+/**
+ * Run a log call only while its site is enabled
+ * (used by the LOG_XXX() macros of both modes)
+ */
+#define _WW_LOG_SITE_GUARD(level, call) do { \
+    static WW_LOG_SITE_T _ww_log_site \
+        __attribute__((section("ww_log_sites"), used)) = \
+        { CURRENT_FILE_ID, level, 1, __LINE__ }; \
+    if (__atomic_load_n(&_ww_log_site.enabled, __ATOMIC_RELAXED) != 0) { \
+        call; \
+    } \
+} while (0)
+
+#else
+
+#define _WW_LOG_SITE_GUARD(level, call)  call
+
+#endif /* WW_LOG_SITE_CTRL_EN */
+
+#endif /* WW_LOG_SITE_H */
@@ -7,7 +7,7 @@
  * - Printf-style human-readable output
  * - Format: [LEVEL] filename:line - message
  * - Module ID automatically determined from CURRENT_MODULE_ID (injected by Makefile)
- * - Dynamic module filtering via g_ww_log_module_mask
+ * - Dynamic module filtering via the module mask (ww_log_modules.h)
  *
  * Usage:
  *   LOG_INF("Message");
@@ -18,6 +18,18 @@
  *   [INF] app_main.c:42 - Application started
  *   [DBG] drv_uart.c:128 - Sending data, length=64
  *
+ * The "[LEVEL] filename:line - " header of LOG_ERR..LOG_DBG is built at
+ * compile time (_WW_LOG_STR_PREFIX): at runtime only the message is
+ * formatted.
+ *
+ * Deferred formatting (-DWW_LOG_STR_DEFERRED_EN, implies WW_LOG_ASYNC_EN):
+ * the caller copies the format and call-site prefix pointers and the raw arguments
+ * (%s strings by value) into the RAM ring, and the drain thread does the
+ * formatting. The format string must therefore outlive the call, i.e. be
+ * a literal as usual. Formats that cannot be deferred (%n, %m, positional
+ * arguments, long double, wide strings, more than the ring record holds)
+ * are formatted by the caller as in async mode.
+ *
  * Note: Module ID is automatically injected by the build system based on
  *       the file's location in log_config.json. No manual module parameter needed!
  */
@@ -55,7 +67,7 @@
 
 /**
  * @brief Core string mode output function (with internal filtering)
- * @param module_id Module ID for filtering (0-31)
+ * @param file_id File ID for filtering (CURRENT_FILE_ID)
  * @param filename Source filename (extracted from __FILE__)
  * @param line Line number
  * @param level Log level (WW_LOG_LEVEL_ERR/WRN/INF/DBG)
@@ -63,14 +75,58 @@
  * @param ... Variable arguments for format string
  *
  * This function performs all filtering checks internally:
- * - Module enable/disable check (via g_ww_log_module_mask)
- * - Log level threshold check (via g_ww_log_level_threshold)
+ * - Module enable/disable and module / file level threshold check
+ *   (via the level table of the configuration snapshot)
  *
  * Output format: [LEVEL] filename:line - formatted_message
  */
-void ww_log_str_output(U8 module_id, const char *filename, U32 line, U8 level,
+void ww_log_str_output(U16 file_id, const char *filename, U32 line, U8 level,
                        const char *fmt, ...);
 
+/**
+ * @brief String mode output with the line header built by the call site
+ * @param file_id File ID for filtering (CURRENT_FILE_ID)
+ * @param prefix "[LEVEL] filename:line - " (static storage, see _WW_LOG_STR_PREFIX)
+ * @param prefix_len Length of prefix without the terminating NUL
+ * @param level Log level (WW_LOG_LEVEL_ERR/WRN/INF/DBG)
+ * @param fmt Printf-style format string
+ * @param ... Variable arguments for format string
+ *
+ * Same filtering and output as ww_log_str_output(); the header is copied
+ * instead of formatted, only the message goes through vsnprintf().
+ */
+void ww_log_str_output_prefix(U16 file_id, const char *prefix, U32 prefix_len, U8 level,
+                              const char *fmt, ...);
+
+/**
+ * @brief Hex dump of a byte buffer (LOG_HEX)
+ * @param file_id File ID for filtering (CURRENT_FILE_ID)
+ * @param filename Source filename
+ * @param line Line number
+ * @param level Log level
+ * @param data Bytes to dump
+ * @param len Number of bytes
+ *
+ * Output: one line with the length, then one line per 16 bytes:
+ *   [DBG] drv_i2c.c:30 - hex 20 bytes
+ *   [DBG] drv_i2c.c:30 - 0000: 50 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F
+ *   [DBG] drv_i2c.c:30 - 0010: 10 11 12 13
+ * The lines are written as one unit (never interleaved with other
+ * output); dumps longer than WW_LOG_STR_LONG_MAX bytes of text end with
+ * a "... N bytes not shown" line.
+ */
+void ww_log_str_hex(U16 file_id, const char *filename, U32 line, U8 level,
+                    const void *data, U32 len);
+
+/**
+ * @brief Report the records suppressed by a call site's rate limit
+ * @param suppressed Suppressed counter of the site (taken and reset)
+ *
+ * Output: [LEVEL] filename:line - N records suppressed (rate limit)
+ */
+void ww_log_str_suppressed(U16 file_id, const char *filename, U32 line, U8 level,
+                           U32 *suppressed);
+
 /* ========== Public Log Macros ========== */
 
 /**
@@ -113,12 +169,44 @@ void ww_log_str_output(U8 module_id, const char *filename, U32 line, U8 level,
 
 /* Internal macro to call log output function */
 #define _WW_LOG_STR_CALL(level, fmt, ...) \
-    ww_log_str_output(CURRENT_MODULE_ID, _WW_LOG_FILENAME(__FILE__), __LINE__, \
+    ww_log_str_output(CURRENT_FILE_ID, _WW_LOG_FILENAME(__FILE__), __LINE__, \
                       level, fmt, ##__VA_ARGS__)
 
+/**
+ * Call-site prefix "[LEVEL] filename:line - " as one string literal
+ *
+ * Level (a number once LOG_XXX has expanded it), __NOTDIR_FILE__ and
+ * __LINE__ are all constants at the call site, so the header is pasted
+ * together by the preprocessor and lands in .rodata next to the format
+ * string. Only with a Makefile-provided __NOTDIR_FILE__; otherwise the
+ * filename is found at runtime and the header formatted per record.
+ */
+#define _WW_LOG_STR_NAME_0  "ERR"
+#define _WW_LOG_STR_NAME_1  "WRN"
+#define _WW_LOG_STR_NAME_2  "INF"
+#define _WW_LOG_STR_NAME_3  "DBG"
+
+#define _WW_LOG_STR_STR(x)  _WW_LOG_STR_STR_IMPL(x)
+#define _WW_LOG_STR_STR_IMPL(x)  #x
+
+#ifdef __NOTDIR_FILE__
+    #define _WW_LOG_STR_PREFIX(level) \
+        "[" _WW_LOG_STR_CAT(_WW_LOG_STR_NAME_, level) "] " \
+        __NOTDIR_FILE__ ":" _WW_LOG_STR_STR(__LINE__) " - "
+
+    #define _WW_LOG_STR_SITE_CALL(level, fmt, ...) \
+        ww_log_str_output_prefix(CURRENT_FILE_ID, _WW_LOG_STR_PREFIX(level), \
+                                 sizeof(_WW_LOG_STR_PREFIX(level)) - 1, \
+                                 level, fmt, ##__VA_ARGS__)
+#else
+    #define _WW_LOG_STR_SITE_CALL(level, fmt, ...) \
+        _WW_LOG_STR_CALL(level, fmt, ##__VA_ARGS__)
+#endif
+
 /* Main expansion macro that checks static switch and conditionally expands */
 #define _WW_LOG_STR_STATIC_EXPAND(level, fmt, ...) \
-    _WW_LOG_STR_IF(CURRENT_MODULE_STATIC_EN)(_WW_LOG_STR_CALL(level, fmt, ##__VA_ARGS__))
+    _WW_LOG_STR_IF(CURRENT_MODULE_STATIC_EN)(_WW_LOG_PREFILTER(level, \
+        _WW_LOG_SITE_GUARD(level, _WW_LOG_STR_SITE_CALL(level, fmt, ##__VA_ARGS__))))
 
 /* Static compile-time filtering for string mode */
 /* Two-level filtering: compile threshold + static module switch */
@@ -150,6 +238,125 @@ void ww_log_str_output(U8 module_id, const char *filename, U32 line, U8 level,
     #define LOG_DBG(fmt, ...) do {} while (0)
 #endif
 
+/**
+ * LOG_HEX(level, data, len) - hex dump of a byte buffer
+ * @param level WW_LOG_LEVEL_xxx (compile-time constant)
+ * @param data Pointer to the bytes
+ * @param len Number of bytes
+ */
+#define LOG_HEX(level, data, len) \
+    _WW_LOG_STR_IF(CURRENT_MODULE_STATIC_EN)(_WW_LOG_PREFILTER(level, \
+        _WW_LOG_SITE_GUARD(level, (((level) <= WW_LOG_COMPILE_THRESHOLD) ? \
+            ww_log_str_hex(CURRENT_FILE_ID, _WW_LOG_FILENAME(__FILE__), __LINE__, \
+                           level, (data), (len)) : (void)0))))
+
+/**
+ * Suppression report of a rate-limited call site (see ww_log_ratelimit.h)
+ */
+#define _WW_LOG_RL_REPORT(level, rl) \
+    ww_log_str_suppressed(CURRENT_FILE_ID, _WW_LOG_FILENAME(__FILE__), __LINE__, \
+                          level, &(rl)->suppressed)
+
+/* ========== Batched Records ========== */
+
+/**
+ * LOG_BATCH_BEGIN(batch, level) / LOG_BATCH_ADD(batch, fmt, ...) /
+ * LOG_BATCH_COMMIT(batch) - same API as in encode mode (ww_log_encode.h)
+ *
+ * Sync mode: LOG_BATCH_ADD() writes its line right away at the batch
+ * level (one sink write per line) and LOG_BATCH_COMMIT() does nothing;
+ * each line is atomic, but lines of other threads can land in between.
+ *
+ * Async mode (also WW_LOG_STR_DEFERRED_EN): as in encode mode the lines
+ * are rendered into text records on the stack and LOG_BATCH_COMMIT()
+ * claims them with one ring reservation, so the drain thread writes
+ * none or all of them, with no other line in between.
+ * - The filter is checked once by LOG_BATCH_BEGIN()
+ * - Lines are rendered by the caller, also with WW_LOG_STR_DEFERRED_EN
+ * - Lines that do not fit in WW_LOG_BATCH_WORDS are left out and the
+ *   batch ends with a warning line counting them; a batch the ring has
+ *   no room for is dropped as a whole
+ */
+#define _WW_LOG_BATCH_LEVEL(batch)  _ww_log_batch_level_##batch
+
+#ifdef WW_LOG_ASYNC_EN
+
+#ifndef WW_LOG_BATCH_WORDS
+#define WW_LOG_BATCH_WORDS  256  /* Text record words per batch (header words included) */
+#endif
+
+#define WW_LOG_BATCH_DROP_WORDS  (1 + 48 / 4)  /* Trailing "lines not shown" record */
+
+typedef struct {
+    U32 words[WW_LOG_BATCH_WORDS + WW_LOG_BATCH_DROP_WORDS];
+    U32 used;       /* Words filled */
+    U16 records;    /* Records in the batch */
+    U16 dropped;    /* Lines that did not fit */
+    U8 enabled;     /* Filter result of LOG_BATCH_BEGIN() */
+    U8 level;       /* Level of the batch */
+} WW_LOG_BATCH_T;
+
+/**
+ * @brief Start a batch and check the filter for it
+ * @param batch Batch (caller storage, usually on the stack)
+ * @param file_id File ID for filtering (CURRENT_FILE_ID)
+ * @param level Level of the batch
+ */
+void ww_log_str_batch_begin(WW_LOG_BATCH_T *batch, U16 file_id, U8 level);
+
+/**
+ * @brief Render a line into a batch
+ * @param batch Enabled batch
+ * @param filename Source filename (without path)
+ * @param line Line number
+ * @param fmt Printf-style format string
+ */
+void ww_log_str_batch_add(WW_LOG_BATCH_T *batch, const char *filename, U32 line,
+                          const char *fmt, ...);
+
+/**
+ * @brief Write all lines of a batch with one ring reservation
+ */
+void ww_log_str_batch_commit(WW_LOG_BATCH_T *batch);
+
+#define _WW_LOG_BATCH_ON(batch) \
+    (_WW_LOG_BATCH_LEVEL(batch) <= WW_LOG_COMPILE_THRESHOLD)
+
+#define _WW_LOG_BATCH_CALL(batch, fmt, ...) \
+    ww_log_str_batch_add(&(batch), _WW_LOG_FILENAME(__FILE__), __LINE__, fmt, ##__VA_ARGS__)
+
+#define LOG_BATCH_BEGIN(batch, level) \
+    _WW_LOG_STR_IF(CURRENT_MODULE_STATIC_EN)( \
+        WW_LOG_BATCH_T batch; \
+        enum { _WW_LOG_BATCH_LEVEL(batch) = (level) }; \
+        if (_WW_LOG_BATCH_ON(batch)) { \
+            ww_log_str_batch_begin(&(batch), CURRENT_FILE_ID, _WW_LOG_BATCH_LEVEL(batch)); \
+        })
+
+#define LOG_BATCH_ADD(batch, fmt, ...) \
+    _WW_LOG_STR_IF(CURRENT_MODULE_STATIC_EN)( \
+        ((_WW_LOG_BATCH_ON(batch) && (batch).enabled) ? \
+            _WW_LOG_BATCH_CALL(batch, fmt, ##__VA_ARGS__) : (void)0))
+
+#define LOG_BATCH_COMMIT(batch) \
+    _WW_LOG_STR_IF(CURRENT_MODULE_STATIC_EN)( \
+        ((_WW_LOG_BATCH_ON(batch) && (batch).enabled) ? \
+            ww_log_str_batch_commit(&(batch)) : (void)0))
+
+#else /* !WW_LOG_ASYNC_EN */
+
+#define LOG_BATCH_BEGIN(batch, level) \
+    enum { _WW_LOG_BATCH_LEVEL(batch) = (level) }
+
+#define LOG_BATCH_ADD(batch, fmt, ...) \
+    _WW_LOG_STR_IF(CURRENT_MODULE_STATIC_EN)(_WW_LOG_PREFILTER(_WW_LOG_BATCH_LEVEL(batch), \
+        (((_WW_LOG_BATCH_LEVEL(batch)) <= WW_LOG_COMPILE_THRESHOLD) ? \
+            _WW_LOG_STR_CALL(_WW_LOG_BATCH_LEVEL(batch), fmt, ##__VA_ARGS__) : (void)0)))
+
+#define LOG_BATCH_COMMIT(batch)  do {} while (0)
+
+#endif /* WW_LOG_ASYNC_EN */
+
 /* ========== Convenience Macros (Optional) ========== */
 
 /**
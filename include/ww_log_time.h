@@ -0,0 +1,132 @@
+/**
+ * @file ww_log_time.h
+ * @brief Record timestamps for encode mode (pluggable clock, delta encoded)
+ * @date 2026-10-16
+ *
+ * Enabled with -DWW_LOG_ENCODE_TIMESTAMP_EN (encode mode only).
+ *
+ * Every record carries one timestamp item as the first payload item:
+ *
+ *   item = (delta << 2) | epoch
+ *
+ * delta is the number of clock ticks since the base of the current sync
+ * epoch. A one-word item in the plain layout, a LEB128 varint (1-4 bytes)
+ * with WW_LOG_ENCODE_COMPACT.
+ *
+ * When delta would reach WW_LOG_TS_SYNC_TICKS, the producer writes a sync
+ * control record with a new absolute base and the next epoch (mod 4)
+ * before switching to it. Records that picked up the previous epoch may
+ * still land after the sync record; the decoder keeps the base of all
+ * four epochs, so they decode correctly.
+ *
+ * ww_log_init() writes a calibration control record (clock ID, tick rate,
+ * a tick/CLOCK_REALTIME reference pair) followed by the first sync
+ * record, so the decoder can convert ticks to nanoseconds and wall time.
+ */
+
+#ifndef WW_LOG_TIME_H
+#define WW_LOG_TIME_H
+
+#include "type.h"
+
+/* ========== Configuration ========== */
+
+/**
+ * Maximum delta before a new sync epoch is started.
+ * Must stay below 2^30 so the item fits one word (and never reads as
+ * WW_LOG_TS_UNKNOWN); the default keeps the compact varint at 4 bytes or
+ * less (67 ms with a nanosecond clock).
+ */
+#ifndef WW_LOG_TS_SYNC_TICKS
+#define WW_LOG_TS_SYNC_TICKS  (1U << 26)
+#endif
+
+#if WW_LOG_TS_SYNC_TICKS >= (1U << 30)
+#error "WW_LOG_TS_SYNC_TICKS must be below 2^30"
+#endif
+
+#define WW_LOG_TS_EPOCH_MASK  0x3
+
+/**
+ * Timestamp item of a record whose epoch could not be started (the sync
+ * record was dropped because the ring was full): time unknown
+ */
+#define WW_LOG_TS_UNKNOWN  0xFFFFFFFFU
+
+/* ========== Clock Sources ========== */
+
+/**
+ * Clock IDs (written to the calibration record)
+ */
+#define WW_LOG_CLOCK_ID_MONOTONIC         0
+#define WW_LOG_CLOCK_ID_MONOTONIC_COARSE  1
+#define WW_LOG_CLOCK_ID_TSC               2
+#define WW_LOG_CLOCK_ID_CUSTOM            3
+
+/**
+ * Clock source
+ * hz == 0 means the rate is measured against CLOCK_MONOTONIC at start.
+ */
+typedef struct {
+    U8 id;                  /* WW_LOG_CLOCK_ID_xxx */
+    const char *name;
+    U64 (*read)(void);      /* Current tick count, monotonic */
+    U64 hz;                 /* Ticks per second, 0 = calibrate */
+} WW_LOG_CLOCK_T;
+
+extern const WW_LOG_CLOCK_T g_ww_log_clock_monotonic;
+extern const WW_LOG_CLOCK_T g_ww_log_clock_monotonic_coarse;
+extern const WW_LOG_CLOCK_T g_ww_log_clock_tsc;  /* x86 TSC / arm64 CNTVCT, else monotonic */
+
+/* ========== Producer State ========== */
+
+/**
+ * Current sync point: (base_ticks << 2) | epoch
+ */
+extern U64 g_ww_log_ts_sync;
+extern const WW_LOG_CLOCK_T *g_ww_log_clock;
+
+/* ========== API Functions ========== */
+
+/**
+ * @brief Select the clock source (call before ww_log_init())
+ * @param clock Clock (storage must stay valid)
+ */
+void ww_log_time_set_clock(const WW_LOG_CLOCK_T *clock);
+
+/**
+ * @brief Calibrate the clock and write the calibration and first sync
+ *        records (called by ww_log_init())
+ */
+void ww_log_time_start(void);
+
+/**
+ * @brief Start a new sync epoch if the current one is exhausted
+ * @param seen Sync value the caller based its delta on
+ * @return Sync value to use; 'seen' again if the sync record was dropped
+ */
+U64 ww_log_time_resync(U64 seen);
+
+/**
+ * @brief Timestamp item for a record being written now
+ * @return (delta << 2) | epoch, or WW_LOG_TS_UNKNOWN if no epoch covers now
+ */
+static inline U32 ww_log_time_item(void)
+{
+    U64 sync = __atomic_load_n(&g_ww_log_ts_sync, __ATOMIC_ACQUIRE);
+    U64 delta = g_ww_log_clock->read() - (sync >> 2);
+
+    while (delta >= WW_LOG_TS_SYNC_TICKS) {
+        U64 next = ww_log_time_resync(sync);
+
+        if (next == sync) {
+            return WW_LOG_TS_UNKNOWN;  /* Sync record dropped: ring full */
+        }
+        sync = next;
+        delta = g_ww_log_clock->read() - (sync >> 2);
+    }
+
+    return (U32)((delta << 2) | (sync & WW_LOG_TS_EPOCH_MASK));
+}
+
+#endif /* WW_LOG_TIME_H */
@@ -14,12 +14,15 @@ void drv_i2c_init(void)
 
 void drv_i2c_read(void)
 {
-    LOG_DBG("I2C read in progress");
+    LOG_DBG_RATELIMIT("I2C read in progress");
     LOG_INF("I2C read complete");
 }
 
 void drv_i2c_write(void)
 {
+    U8 frame[4] = { 0xA0, 0x10, 0xAB, 0xCD };  /* Address (write), register, data */
+
     LOG_DBG("I2C write in progress");
+    LOG_HEX(WW_LOG_LEVEL_DBG, frame, sizeof(frame));
     LOG_INF("I2C write complete");
 }
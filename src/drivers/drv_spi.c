@@ -14,6 +14,14 @@ void drv_spi_init(void)
 
 void drv_spi_transfer(void)
 {
+    U8 tx[64];
+    U32 i;
+
+    for (i = 0; i < sizeof(tx); i++) {
+        tx[i] = (U8)i;
+    }
+
     LOG_DBG("SPI transfer in progress");
+    LOG_HEX(WW_LOG_LEVEL_DBG, tx, sizeof(tx));
     LOG_INF("SPI transfer complete");
 }
@@ -6,9 +6,12 @@
 
 #include "drv_in.h"
 
+static char g_uart_dev[32] = "/dev/ttyS0";
+
 void drv_uart_init(void)
 {
     LOG_INF("UART driver init");
+    LOG_INF("UART device %s, parity %s", g_uart_dev, "none");
     LOG_DBG("UART baud rate: 115200");
 }
 
@@ -17,8 +17,9 @@ void test_stress_run(void)
 
     LOG_DBG("Running stress test with %d iterations...", iterations);
 
-    for (int i = 0; i < 10; i++) {
-        LOG_DBG("Stress iteration %d", i);
+    for (int i = 0; i < iterations; i++) {
+        LOG_INF_ONCE("First stress iteration started");
+        LOG_DBG_RATELIMIT("Stress iteration %d", i);
     }
 
     LOG_INF("Stress tests complete, iterations=%d", iterations);
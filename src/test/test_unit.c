@@ -36,6 +36,11 @@ void test_unit_run(void)
 
     LOG_INF("Unit tests complete, passed=%d, failed=%d", passed, failed);
 
+    /* 64-bit and floating-point values are logged at full width */
+    unsigned long long elapsed_ns = 0x1234567890ULL;
+    double pass_ratio = (double)passed / (passed + failed);
+    LOG_DBG("Unit test timing: elapsed=%llu ns, pass ratio=%f", elapsed_ns, pass_ratio);
+
     if (failed > 0) {
         LOG_WRN("Some tests failed!");
     }
@@ -6,6 +6,7 @@ Generates Makefile variable definitions and C header from log_config.json
 All module configuration is centralized in log_config.json:
 - Module IDs and names
 - Module enable/disable (static compile-time switch)
+- Module / file compile-time level (optional "compile_level")
 - File IDs and mappings
 """
 
@@ -26,6 +27,27 @@ def load_config(config_file):
         print(f"Error: Invalid JSON in '{config_file}': {e}", file=sys.stderr)
         sys.exit(1)
 
+LEVEL_NAMES = {'ERR': 0, 'WRN': 1, 'INF': 2, 'DBG': 3}
+
+def parse_compile_level(value, where):
+    """Convert a compile_level ("ERR".."DBG" or 0-3) to its number"""
+    if isinstance(value, str) and value.upper() in LEVEL_NAMES:
+        return LEVEL_NAMES[value.upper()]
+    if isinstance(value, int) and not isinstance(value, bool) and 0 <= value <= 3:
+        return value
+    print(f"Error: Invalid compile_level {value!r} for {where} "
+          f"(use ERR, WRN, INF, DBG or 0-3)", file=sys.stderr)
+    sys.exit(1)
+
+def get_files_per_module(config):
+    """File ID slots per module (optional top-level "files_per_module")"""
+    return config.get('files_per_module', 64)
+
+def get_module_max(config):
+    """Size of the runtime module bitmap: highest module ID + 1, in steps of 32"""
+    max_id = max((m.get('id', 0) for m in config.get('modules', {}).values()), default=0)
+    return max(32, (max_id + 32) // 32 * 32)
+
 def generate_makefile_vars(config):
     """Generate Makefile variable definitions"""
     modules = config.get('modules', {})
@@ -66,11 +88,21 @@ def generate_makefile_vars(config):
         file_id = base_id + offset
         module_id = module.get('id', 0)
 
+        if offset >= get_files_per_module(config):
+            print(f"Error: offset {offset} of {file_path} exceeds files_per_module "
+                  f"({get_files_per_module(config)})", file=sys.stderr)
+            sys.exit(1)
+
         # Generate Makefile variable (replace special characters)
         # Convert path to valid Make variable name
         var_name = f"FILE_ID_{file_path}".replace('/', '_').replace('.', '_').replace('-', '_')
         module_var_name = f"MODULE_ID_{file_path}".replace('/', '_').replace('.', '_').replace('-', '_')
         static_var_name = f"MODULE_STATIC_EN_{file_path}".replace('/', '_').replace('.', '_').replace('-', '_')
+        level_var_name = f"MODULE_COMPILE_LEVEL_{file_path}".replace('/', '_').replace('.', '_').replace('-', '_')
+
+        # Compile-time level: file overrides module, none = global threshold only
+        compile_level = file_info.get('compile_level', module.get('compile_level'))
+        level_src = file_path if 'compile_level' in file_info else f"module {module_name}"
 
         # Add comment with description if available
         desc = file_info.get('description', '')
@@ -80,6 +112,9 @@ def generate_makefile_vars(config):
         lines.append(f"{var_name} = {file_id}")
         lines.append(f"{module_var_name} = {module_id}")
         lines.append(f"{static_var_name} = 1")  # Module is enabled
+        if compile_level is not None:
+            level = parse_compile_level(compile_level, level_src)
+            lines.append(f"{level_var_name} = {level}")
         enabled_count += 1
 
     lines.append("")
@@ -125,7 +160,10 @@ def generate_c_header(config):
             lines.append(f"#define WW_LOG_MODULE_{module_name.upper()}  {module_id}")
 
     lines.append("")
-    lines.append(f"#define WW_LOG_MODULE_MAX  32  /**< Maximum number of modules */")
+    lines.append("#ifndef WW_LOG_MODULE_MAX")
+    lines.append(f"#define WW_LOG_MODULE_MAX  {get_module_max(config)}  /**< Maximum number of modules */")
+    lines.append("#endif")
+    lines.append(f"#define WW_LOG_FILES_PER_MODULE  {get_files_per_module(config)}  /**< File IDs per module */")
     lines.append("")
 
     # ========== File ID Definitions ==========
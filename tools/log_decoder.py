@@ -1,9 +1,9 @@
 #!/usr/bin/env python3
 """
 Log Decoder for Encode Mode
-Decodes binary log entries to human-readable format
+Decodes encoded log records to human-readable format
 
-Encoding format (32-bit header):
+Encoding format v1 (stream version 1, WW_LOG_ENCODE_V1, 32-bit header):
   Bits 31-20: LOG_ID (12 bits, 0-4095)
   Bits 19-8:  LINE (12 bits, 0-4095)
   Bits 7-2:   DATA_LEN (6 bits, 0-63)
@@ -11,17 +11,105 @@ Encoding format (32-bit header):
 
 Followed by DATA_LEN U32 parameter values
 
-Output format:
-  0xHHHHHHHH 0xPPPPPPPP 0xPPPPPPPP ...
-  ^header    ^param1   ^param2
+Encoding format v2 (stream version 2, default, two header words):
+  Word 0 bits 31-16: LOG_ID (16 bits), bits 15-8: FLAGS (bit 0 = typed),
+         bits 7-2: DATA_LEN, bits 1-0: LEVEL
+  Word 1: LINE (32 bits)
+  DATA_LEN counts the words after word 0 (LINE word + payload)
+
+The version is taken from the stream header; both are framed as
+1 + DATA_LEN words.
+
+Typed records (v1: LOG_ID bit 11 set, v2: FLAGS bit 0 set;
+64-bit/pointer/floating-point params):
+  payload = descriptor words + values
+  descriptor: 3-bit type tag per parameter, 10 per word, bit 31 = more
+  tags: 0 U32, 1 U64, 2 F32, 3 F64, 4 PTR32, 5 PTR64, 6 STR
+  64-bit values take 2 words, low word first
+  strings: item (id << 1) | 1 = literal at offset id of the string table
+  (build/log_strtab.bin, extracted from the ww_log_strtab section), or
+  item (len << 2) | (truncated << 1) followed by len bytes (plain: padded
+  to whole words)
+
+Blob records (LOG_HEX, typed record whose first tag is 7):
+  payload = descriptor + total length + bytes (word aligned)
+  descriptor: bits 2-0 tag 7, bits 10-3 chunk length, bits 30-11 offset
+  byte k = bits 8*(k%4).. of word k/4; printed as a hex dump
+
+Compact payload (stream flag 0x0002, WW_LOG_ENCODE_COMPACT):
+  payload words are a byte stream, byte k = bits 8*(k%4).. of word k/4
+  32-bit and 64-bit integers: zigzag + LEB128, pointers and descriptors:
+  LEB128, float/double: 4/8 raw bytes; trailing 0x80 bytes are padding
+
+Timestamps (stream flag 0x0004, WW_LOG_ENCODE_TIMESTAMP_EN):
+  first payload item of every record (word, or varint when compact):
+  item = (delta << 2) | epoch, delta = clock ticks since the epoch base
+  control records (LOG_ID 0xFFF / v2 0xFFFF, type in LINE, plain word payload):
+    1 calibration: [clock][hz lo][hz hi][ref ticks lo/hi][ref realtime ns lo/hi]
+    2 sync:        [epoch][base ticks lo][base ticks hi]
+    3 drop marker: [records dropped] (RAM ring was full before this point)
+    4 suppressed:  [site header][records suppressed by its rate limit]
+  times are printed relative to the calibration reference
+
+Input formats (detected automatically):
+  Hex text:  one record per line
+      0xHHHHHHHH 0xPPPPPPPP 0xPPPPPPPP ...
+      ^header    ^param1   ^param2
+  Binary:    raw U32 words (WW_LOG_ENCODE_OUTPUT_BIN)
+
+Both formats start with a stream header:
+  [0x574C4753 "WLGS"] [FLAGS << 16 | VERSION] [BOM 0x01020304]
+The byte order mark gives the endianness of binary captures.
+
+Sync frames (stream flag 0x0008, WW_LOG_ENCODE_SYNC_EN):
+  [0x574C5346 "WLSF"] [SEQ] [CRC32C of the words since the previous frame]
+  CRC over the word values, low byte first. A block whose CRC does not
+  match is skipped and decoding continues after the next good frame
+  (binary captures are searched byte by byte); the skipped bytes are
+  reported as RESYNC lines. Words after the last frame are unchecked.
+
+File and module names are taken from log_config.json.
 
 Usage:
-  python3 log_decoder.py <encoded_log_file>
+  python3 log_decoder.py [--config log_config.json] [--strtab log_strtab.bin] <encoded_log_file>
   python3 log_decoder.py -  (read from stdin)
 """
 
-import sys
+import datetime
+import os
 import re
+import struct
+import sys
+
+STREAM_MAGIC = 0x574C4753
+STREAM_BOM = 0x01020304
+STREAM_FLAG_BIN = 1 << 0
+STREAM_FLAG_COMPACT = 1 << 1
+STREAM_FLAG_TS = 1 << 2
+STREAM_FLAG_SYNC = 1 << 3
+SYNC_MAGIC = 0x574C5346
+
+CTRL_LOG_ID = {1: 0xFFF, 2: 0xFFFF}
+CTRL_CALIB = 1
+CTRL_SYNC = 2
+CTRL_DROP = 3
+CTRL_SUPPRESS = 4
+
+TS_UNKNOWN = 0xFFFFFFFF  # Timestamp item: sync record dropped, time unknown
+
+CLOCK_NAMES = {0: "monotonic", 1: "monotonic_coarse", 2: "tsc", 3: "custom"}
+
+EXT_FLAG = 0x800
+EXT_FLAG_V2 = 1 << 8
+HDR_WORDS = {1: 1, 2: 2}
+EXT_TAGS_PER_WORD = 10
+EXT_DESC_MORE = 1 << 31
+TAG_U32, TAG_U64, TAG_F32, TAG_F64, TAG_PTR32, TAG_PTR64, TAG_STR = range(7)
+STR_ID_FLAG = 1 << 0
+STR_TRUNC_FLAG = 1 << 1
+TAG_BLOB = 7
+HEX_LINE_BYTES = 16
+SUPPORTED_VERSIONS = (1, 2)
 
 # Log level names
 LEVEL_NAMES = {
@@ -31,40 +119,64 @@ LEVEL_NAMES = {
     3: "DBG",
 }
 
-# Module/File ID to name mapping
-FILE_ID_MAP = {
-    0: "main.c",
-    # DEMO module (32-63)
-    32: "demo (default)",
-    33: "demo_init.c",
-    34: "demo_process.c",
-    # TEST module (64-95)
-    64: "test (default)",
-    65: "test_unit.c",
-    66: "test_integration.c",
-    67: "test_stress.c",
-    # APP module (96-127)
-    96: "app (default)",
-    97: "app_main.c",
-    98: "app_config.c",
-    # DRIVERS module (128-159)
-    128: "drivers (default)",
-    129: "drv_uart.c",
-    130: "drv_spi.c",
-    131: "drv_i2c.c",
-    # BROM module (160-191)
-    160: "brom (default)",
-    161: "brom_boot.c",
-    162: "brom_loader.c",
-}
+DEFAULT_CONFIG = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                              '..', 'log_config.json')
+DEFAULT_STRTAB = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                              '..', 'build', 'log_strtab.bin')
+
+# Module/File ID to name mapping, filled from log_config.json
+FILE_ID_MAP = {}
+MODULE_NAMES = {}
+
+# Interned string literals (contents of the ww_log_strtab section)
+STRING_TABLE = b''
+
+
+def load_config(config_file):
+    """Build FILE_ID_MAP and MODULE_NAMES from log_config.json"""
+    import json
+
+    try:
+        with open(config_file, 'r', encoding='utf-8') as f:
+            config = json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"Warning: cannot load '{config_file}': {e}", file=sys.stderr)
+        return
+
+    modules = config.get('modules', {})
+    files_per_module = config.get('files_per_module', 64)
+    for name, info in modules.items():
+        base_id = info.get('base_id', 0)
+        MODULE_NAMES[range(base_id, base_id + files_per_module)] = name[:4]
+
+    for path, info in config.get('files', {}).items():
+        module = modules.get(info.get('module'))
+        if module is None:
+            continue
+        file_id = module.get('base_id', 0) + info.get('offset', 0)
+        FILE_ID_MAP[file_id] = os.path.basename(path)
+
+
+def load_strtab(strtab_file):
+    """Load the string table written by the build (optional)"""
+    global STRING_TABLE
+
+    try:
+        with open(strtab_file, 'rb') as f:
+            STRING_TABLE = f.read()
+    except OSError:
+        STRING_TABLE = b''
+
+
+def lookup_string(str_id):
+    """Interned literal at offset str_id, None if not in the table"""
+    if str_id >= len(STRING_TABLE):
+        return None
+    end = STRING_TABLE.find(b'\0', str_id)
+    if end < 0:
+        end = len(STRING_TABLE)
+    return STRING_TABLE[str_id:end].decode('utf-8', errors='replace')
 
-MODULE_NAMES = {
-    range(32, 64): "DEMO",
-    range(64, 96): "TEST",
-    range(96, 128): "APP",
-    range(128, 160): "DRV",
-    range(160, 192): "BROM",
-}
 
 def get_module_name(log_id):
     for id_range, name in MODULE_NAMES.items():
@@ -72,18 +184,34 @@ def get_module_name(log_id):
             return name
     return "UNKNOWN"
 
-def decode_log_entry(encoded_value):
+
+def decode_log_entry(encoded_value, version=1, line_word=0):
+    """Decode header word 0 (v2: LINE from the second header word)
+
+    data_len is the number of words after word 0 (v2: including LINE)
+    """
     if isinstance(encoded_value, str):
         encoded_value = int(encoded_value, 16)
 
-    log_id = (encoded_value >> 20) & 0xFFF
-    line = (encoded_value >> 8) & 0xFFF
+    if version == 2:
+        log_id = (encoded_value >> 16) & 0xFFFF
+        typed = bool(encoded_value & EXT_FLAG_V2)
+        control = log_id == CTRL_LOG_ID[2]
+        line = line_word
+    else:
+        log_id = (encoded_value >> 20) & 0xFFF
+        control = log_id == CTRL_LOG_ID[1]
+        typed = bool(log_id & EXT_FLAG)
+        log_id &= ~EXT_FLAG
+        line = (encoded_value >> 8) & 0xFFF
     data_len = (encoded_value >> 2) & 0x3F
     level = encoded_value & 0x3
 
     return {
         'raw': encoded_value,
         'log_id': log_id,
+        'typed': typed,
+        'control': control,
         'line': line,
         'data_len': data_len,
         'level': level,
@@ -92,69 +220,515 @@ def decode_log_entry(encoded_value):
         'module_name': get_module_name(log_id),
     }
 
-def format_decoded_log(decoded, params):
-    result = (f"[{decoded['level_name']}][{decoded['module_name']}] "
-              f"{decoded['file_name']}:{decoded['line']}")
 
-    if params:
+def unzigzag(value, bits):
+    value = (value >> 1) ^ -(value & 1)
+    return value & ((1 << bits) - 1)
+
+
+class CompactReader:
+    """Read bytes/varints from a compact payload"""
+
+    def __init__(self, payload):
+        self.data = b''.join(struct.pack('<I', w) for w in payload)
+        self.pos = 0
+
+    def varint(self):
+        """Next LEB128 value, None at the end (or in the padding)"""
+        value = 0
+        shift = 0
+        while self.pos < len(self.data):
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+        return None
+
+    def bytes(self, size):
+        data = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return data
+
+    def raw(self, size):
+        if self.pos + size > len(self.data):
+            return None
+        value = int.from_bytes(self.data[self.pos:self.pos + size], 'little')
+        self.pos += size
+        return value
+
+
+def decode_compact_params(reader):
+    """Plain record, compact payload: zigzag varints"""
+    values = []
+    while True:
+        value = reader.varint()
+        if value is None:
+            return values
+        values.append(unzigzag(value, 32))
+
+
+def decode_compact_typed(reader):
+    """Typed record, compact payload: [(tag, value)]"""
+    tags = []
+    while True:
+        desc = reader.varint()
+        if desc is None:
+            return []
+        tags.extend((desc >> (3 * i)) & 0x7 for i in range(EXT_TAGS_PER_WORD))
+        if not desc & EXT_DESC_MORE:
+            break
+
+    items = []
+    for tag in tags:
+        if tag == TAG_STR:
+            item = reader.varint()
+            if item is None:
+                break
+            value = (item, None if item & STR_ID_FLAG else reader.bytes(item >> 2))
+        elif tag == TAG_F32:
+            value = reader.raw(4)
+        elif tag == TAG_F64:
+            value = reader.raw(8)
+        else:
+            value = reader.varint()
+            if value is not None and tag == TAG_U64:
+                value = unzigzag(value, 64)
+            elif value is not None and tag == TAG_U32:
+                value = unzigzag(value, 32)
+        if value is None:
+            break
+        items.append((tag, value))
+    return items
+
+
+def split_typed_params(payload):
+    """Typed record, word payload: [(tag, value)]"""
+    tags = []
+    idx = 0
+    while idx < len(payload):
+        desc = payload[idx]
+        idx += 1
+        tags.extend((desc >> (3 * i)) & 0x7 for i in range(EXT_TAGS_PER_WORD))
+        if not desc & EXT_DESC_MORE:
+            break
+
+    items = []
+    for tag in tags:
+        if idx >= len(payload):
+            break
+        low = payload[idx]
+        if tag == TAG_STR:
+            data = None
+            idx += 1
+            if not low & STR_ID_FLAG:
+                size = low >> 2
+                data = b''.join(struct.pack('<I', w)
+                                for w in payload[idx:idx + (size + 3) // 4])[:size]
+                idx += (size + 3) // 4
+            items.append((tag, (low, data)))
+            continue
+        if tag in (TAG_U64, TAG_F64, TAG_PTR64):
+            if idx + 1 >= len(payload):
+                break
+            value = low | (payload[idx + 1] << 32)
+            idx += 2
+        else:
+            value = low
+            idx += 1
+        items.append((tag, value))
+    return items
+
+
+def format_string(item, data):
+    """String parameter: interned literal or copied bytes"""
+    if item & STR_ID_FLAG:
+        text = lookup_string(item >> 1)
+        return repr(text) if text is not None else f"str#{item >> 1}"
+    text = repr(data.decode('utf-8', errors='replace'))
+    return text + "..." if item & STR_TRUNC_FLAG else text
+
+
+def format_typed_params(items):
+    """Format (tag, value) pairs"""
+    values = []
+    for tag, value in items:
+        if tag == TAG_U64:
+            values.append(f"0x{value:016X}")
+        elif tag == TAG_F32:
+            values.append(repr(struct.unpack('<f', struct.pack('<I', value))[0]))
+        elif tag == TAG_F64:
+            values.append(repr(struct.unpack('<d', struct.pack('<Q', value))[0]))
+        elif tag == TAG_PTR32:
+            values.append(f"ptr:0x{value:08X}")
+        elif tag == TAG_PTR64:
+            values.append(f"ptr:0x{value:016X}")
+        elif tag == TAG_STR:
+            values.append(format_string(*value))
+        else:
+            values.append(f"0x{value:08X}")
+    return values
+
+
+def split_blob(params, reader=None):
+    """Blob record: (offset, total, bytes), None if the record is not a blob"""
+    if reader is not None:
+        start = reader.pos
+        desc = reader.varint()
+        if desc is None or desc & 0x7 != TAG_BLOB:
+            reader.pos = start
+            return None
+        total = reader.varint()
+        reader.pos = (reader.pos + 3) & ~3
+        data = reader.data[reader.pos:]
+    else:
+        if len(params) < 2 or params[0] & 0x7 != TAG_BLOB:
+            return None
+        desc, total = params[0], params[1]
+        data = b''.join(struct.pack('<I', w) for w in params[2:])
+    chunk = (desc >> 3) & 0xFF
+    return (desc >> 11) & 0xFFFFF, total or 0, data[:chunk]
+
+
+def format_blob(offset, total, data):
+    """Summary and hex dump lines of one blob chunk"""
+    summary = f" Hex: {total} bytes"
+    if len(data) < total:
+        summary += f" [0x{offset:X}-0x{offset + len(data):X})"
+    lines = []
+    for pos in range(0, len(data), HEX_LINE_BYTES):
+        row = data[pos:pos + HEX_LINE_BYTES]
+        lines.append(f"      {offset + pos:04X}: " + " ".join(f"{b:02X}" for b in row))
+    return summary, lines
+
+
+class StreamClock:
+    """Timestamp state of a stream: calibration and sync epoch bases"""
+
+    def __init__(self):
+        self.hz = 0
+        self.ref_ticks = 0
+        self.bases = {}
+
+    def control(self, ctrl_type, words):
+        """Apply a control record, returns its description"""
+        if ctrl_type == CTRL_CALIB and len(words) >= 7:
+            self.hz = words[1] | (words[2] << 32)
+            self.ref_ticks = words[3] | (words[4] << 32)
+            ref_ns = words[5] | (words[6] << 32)
+            wall = datetime.datetime.fromtimestamp(ref_ns / 1e9, datetime.timezone.utc)
+            return (f"# Clock: {CLOCK_NAMES.get(words[0], words[0])}, {self.hz} Hz, "
+                    f"t=0 at {wall.isoformat()}")
+        if ctrl_type == CTRL_SYNC and len(words) >= 3:
+            base = words[1] | (words[2] << 32)
+            self.bases[words[0] & 0x3] = base
+            return f"# Sync: epoch {words[0] & 0x3}, base {base}"
+        return f"# Control record {ctrl_type}: {[f'0x{w:08X}' for w in words]}"
+
+    def format(self, item):
+        if item is None or item == TS_UNKNOWN:
+            return "[+?]"
+        epoch = item & 0x3
+        delta = item >> 2
+        if epoch not in self.bases or self.hz == 0:
+            return f"[epoch {epoch} +{delta}]"
+        ns = (self.bases[epoch] + delta - self.ref_ticks) * 1000000000 // self.hz
+        return f"[+{ns // 1000000000}.{ns % 1000000000:09d}s]"
+
+
+def format_decoded_log(decoded, params, compact=False, clock=None):
+    reader = CompactReader(params) if compact else None
+    result = ""
+
+    if clock is not None:
+        if compact:
+            item = reader.varint()
+        else:
+            item = params[0] if params else None
+            params = params[1:]
+        result = clock.format(item) + " "
+
+    result += (f"[{decoded['level_name']}][{decoded['module_name']}] "
+               f"{decoded['file_name']}:{decoded['line']}")
+
+    blob = split_blob(params, reader) if decoded['typed'] else None
+    if blob is not None:
+        summary, dump = format_blob(*blob)
+        result += summary + f" [Raw: 0x{decoded['raw']:08X}]"
+        return "\n".join([result] + dump)
+
+    if decoded['typed']:
+        items = decode_compact_typed(reader) if compact else split_typed_params(params)
+        result += " Params:[" + ", ".join(format_typed_params(items)) + "]"
+    elif compact:
+        params = decode_compact_params(reader)
+        if params:
+            result += " Params:[" + ", ".join([f"0x{p:08X}" for p in params]) + "]"
+    elif params:
         params_str = " Params:[" + ", ".join([f"0x{p:08X}" for p in params]) + "]"
         result += params_str
 
     result += f" [Raw: 0x{decoded['raw']:08X}]"
     return result
 
+
+# ========== Sync Frames ==========
+
+def make_crc32c_table():
+    table = []
+    for i in range(256):
+        crc = i
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0x82F63B78 if crc & 1 else 0)
+        table.append(crc)
+    return table
+
+
+CRC32C_TABLE = make_crc32c_table()
+
+
+def crc32c(data):
+    """CRC32C (Castagnoli) of a byte string"""
+    crc = 0xFFFFFFFF
+    for b in data:
+        crc = CRC32C_TABLE[(crc ^ b) & 0xFF] ^ (crc >> 8)
+    return crc ^ 0xFFFFFFFF
+
+
+class StreamGap:
+    """Part of a framed stream that failed the CRC check and was skipped"""
+    def __init__(self, lost_bytes, lost_blocks):
+        self.lost_bytes = lost_bytes
+        self.lost_blocks = lost_blocks
+
+
+def unpack_words(data, endian):
+    count = len(data) // 4
+    return list(struct.unpack_from(f"{endian}{count}I", data))
+
+
+def split_frames(data, endian):
+    """Check the blocks of a framed stream (bytes after the stream header)
+
+    Returns the record words of every block whose CRC matches the frame
+    after it, with a StreamGap in place of what had to be skipped, then the
+    unchecked words after the last frame. A magic that does not close a
+    good block is either damaged data or a parameter that happens to equal
+    the magic: it is kept as a candidate start, and the first later frame
+    whose CRC matches from the stream position or from one of these
+    candidates decides which bytes were bad.
+    """
+    magic = struct.pack(endian + 'I', SYNC_MAGIC)
+    out = []
+    start = 0
+    seq = -1
+    candidates = []
+
+    pos = data.find(magic)
+    while 0 <= pos and pos + 12 <= len(data):
+        frame_seq, frame_crc = struct.unpack_from(endian + 'II', data, pos + 4)
+        for begin in [start] + [c + 12 for c in candidates]:
+            block = data[begin:pos]
+            if len(block) % 4 != 0:
+                continue
+            words = unpack_words(block, endian)
+            if endian != '<':
+                block = struct.pack(f"<{len(words)}I", *words)
+            if crc32c(block) == frame_crc:
+                break
+        else:
+            candidates.append(pos)
+            pos = data.find(magic, pos + 1)
+            continue
+
+        if begin > start or frame_seq != (seq + 1) & 0xFFFFFFFF:
+            out.append(StreamGap(begin - start, (frame_seq - seq - 1) & 0xFFFFFFFF))
+        out.extend(words)
+        seq = frame_seq
+        start = pos + 12
+        candidates = []
+        pos = data.find(magic, start)
+
+    # Frames found after the last good one: everything up to them is bad
+    if candidates:
+        out.append(StreamGap(candidates[-1] + 12 - start, len(candidates)))
+        start = candidates[-1] + 12
+    out.extend(unpack_words(data[start:], endian))
+    return out
+
+
+# ========== Input Readers ==========
+
+def find_binary_stream(data):
+    """Locate the stream header in binary data, return (offset, endian)"""
+    for endian in ('<', '>'):
+        magic = struct.pack(endian + 'I', STREAM_MAGIC)
+        offset = data.find(magic)
+        while offset >= 0:
+            if offset + 12 <= len(data):
+                _, _, bom = struct.unpack_from(endian + 'III', data, offset)
+                if bom == STREAM_BOM:
+                    return offset, endian
+            offset = data.find(magic, offset + 1)
+    return None, None
+
+
+def read_stream_words(data, endian):
+    """Unpack stream bytes into U32 words, checking the sync frames if present"""
+    words = unpack_words(data[:12], endian)
+    if len(words) == 3 and words[0] == STREAM_MAGIC and (words[1] >> 16) & STREAM_FLAG_SYNC:
+        return words + split_frames(data[12:], endian)
+    return unpack_words(data, endian)
+
+
+def read_binary_words(data):
+    """Unpack a binary capture into U32 words (starting at the stream header)"""
+    offset, endian = find_binary_stream(data)
+    if offset is None:
+        return None
+    return read_stream_words(data[offset:], endian)
+
+
+def read_text_words(text):
+    """Collect the hex words of all record lines ('0x...' at line start)"""
+    words = []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line.startswith('0x'):
+            continue
+        words.extend(int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{1,8})', line))
+    return words
+
+
+def read_words(raw):
+    """Detect the input format and return (format_name, words)"""
+    words = read_binary_words(raw)
+    if words is not None:
+        return "binary", words
+    words = read_text_words(raw.decode('utf-8', errors='replace'))
+    return "text", read_stream_words(struct.pack(f"<{len(words)}I", *words), '<')
+
+
+# ========== Record Decoding ==========
+
+def decode_words(words):
+    """Decode a word stream, returns (output lines, record count, records dropped, bytes skipped)"""
+    out = []
+    idx = 0
+    count = 0
+    dropped = 0
+    skipped = 0
+    compact = False
+    clock = None
+    version = 1
+
+    while idx < len(words):
+        word = words[idx]
+
+        # Block skipped by the sync frame check
+        if isinstance(word, StreamGap):
+            skipped += word.lost_bytes
+            out.append(f"# RESYNC: skipped {word.lost_bytes} bytes ({word.lost_blocks} blocks) "
+                       f"before record {count} (CRC mismatch)")
+            idx += 1
+            continue
+
+        # Stream header: [MAGIC][FLAGS|VERSION][BOM]
+        if word == STREAM_MAGIC and idx + 2 < len(words) and words[idx + 2] == STREAM_BOM:
+            version = words[idx + 1] & 0xFFFF
+            flags = words[idx + 1] >> 16
+            if version not in SUPPORTED_VERSIONS:
+                out.append(f"WARNING: unsupported stream version {version}")
+                version = 1
+            compact = bool(flags & STREAM_FLAG_COMPACT)
+            clock = StreamClock() if flags & STREAM_FLAG_TS else None
+            out.append(f"# Stream header: version {version}, flags 0x{flags:04X}")
+            idx += 3
+            continue
+
+        hdr_words = HDR_WORDS[version]
+        line_word = words[idx + 1] if hdr_words == 2 and idx + 1 < len(words) else 0
+        decoded = decode_log_entry(word, version, line_word)
+        params = words[idx + hdr_words: idx + 1 + decoded['data_len']]
+        if idx + 1 + decoded['data_len'] > len(words) or decoded['data_len'] < hdr_words - 1:
+            out.append(f"ERROR: truncated record 0x{word:08X}")
+
+        # Control record: [LOG_ID 0xFFF / 0xFFFF][type in LINE]
+        if decoded['control'] and decoded['line'] == CTRL_DROP:
+            lost = params[0] if params else 0
+            dropped += lost
+            out.append(f"# GAP: {lost} records dropped before record {count} (ring full)")
+            idx += 1 + decoded['data_len']
+            continue
+        if decoded['control'] and decoded['line'] == CTRL_SUPPRESS and len(params) > hdr_words:
+            site = decode_log_entry(params[0], version, params[1] if hdr_words == 2 else 0)
+            out.append(f"# SUPPRESSED: {params[hdr_words]} records from "
+                       f"{site['file_name']}:{site['line']} (rate limit)")
+            idx += 1 + decoded['data_len']
+            continue
+        if decoded['control']:
+            if clock is None:
+                clock = StreamClock()
+            out.append(clock.control(decoded['line'], params))
+            idx += 1 + decoded['data_len']
+            continue
+
+        out.append(f"{count:4d}: {format_decoded_log(decoded, params, compact, clock)}")
+        count += 1
+        idx += 1 + decoded['data_len']
+
+    return out, count, dropped, skipped
+
+
 def main():
-    if len(sys.argv) < 2:
-        print("Usage: python3 log_decoder.py <file|->")
+    args = sys.argv[1:]
+    config_file = DEFAULT_CONFIG
+    strtab_file = DEFAULT_STRTAB
+
+    while len(args) >= 2 and args[0] in ('--config', '--strtab'):
+        if args[0] == '--config':
+            config_file = args[1]
+        else:
+            strtab_file = args[1]
+        args = args[2:]
+
+    if len(args) < 1:
+        print("Usage: python3 log_decoder.py [--config log_config.json] "
+              "[--strtab log_strtab.bin] <file|->")
         sys.exit(1)
 
-    if sys.argv[1] == '-':
-        input_file = sys.stdin
+    load_config(config_file)
+    load_strtab(strtab_file)
+
+    if args[0] == '-':
+        raw = sys.stdin.buffer.read()
         filename = "stdin"
     else:
         try:
-            input_file = open(sys.argv[1], 'r')
-            filename = sys.argv[1]
+            with open(args[0], 'rb') as f:
+                raw = f.read()
+            filename = args[0]
         except FileNotFoundError:
-            print(f"Error: File '{sys.argv[1]}' not found")
+            print(f"Error: File '{args[0]}' not found")
             sys.exit(1)
 
-    print(f"Decoding logs from {filename}...")
-    print("=" * 80)
+    fmt, words = read_words(raw)
 
-    count = 0
-    try:
-        for line in input_file:
-            line = line.strip()
-            if not line or line.startswith('#'):
-                continue
-
-            # Extract all hex values from the line
-            hex_values = re.findall(r'0x([0-9A-Fa-f]{1,8})', line)
-            if not hex_values:
-                continue
+    print(f"Decoding logs from {filename} ({fmt})...")
+    print("=" * 80)
 
-            try:
-                # First hex value is the header
-                header_hex = hex_values[0]
-                decoded = decode_log_entry(f"0x{header_hex}")
-
-                # Following hex values are parameters
-                data_len = decoded['data_len']
-                params = []
-                for i in range(1, min(1 + data_len, len(hex_values))):
-                    params.append(int(hex_values[i], 16))
-
-                print(f"{count:4d}: {format_decoded_log(decoded, params)}")
-                count += 1
-            except Exception as e:
-                print(f"ERROR decoding line '{line}': {e}")
-    finally:
-        if input_file != sys.stdin:
-            input_file.close()
+    lines, count, dropped, skipped = decode_words(words)
+    for line in lines:
+        print(line)
 
     print("=" * 80)
     print(f"Decoded {count} log entries")
+    if dropped:
+        print(f"WARNING: {dropped} records were dropped (see GAP lines)")
+    if skipped:
+        print(f"WARNING: {skipped} bytes skipped in damaged blocks (see RESYNC lines)")
+
 
 if __name__ == "__main__":
     main()